@@ -0,0 +1,230 @@
+#pragma once
+
+// Lock-free channels from background producer threads to the UI thread.
+// - LatestValue<T>: triple-buffered cell, one producer. The UI reads the newest complete value in place,
+//   never waits for the producer and never copies.
+// - SpscQueue<T, Capacity> / MpscQueue<T, Capacity>: bounded event queues, one or many producers, one consumer (the UI).
+//   Pushing never blocks: a full queue returns false and the producer decides whether to drop or retry.
+// - ChannelWakeup: pushes one SDL user event when a producer publishes, so an event-driven main loop wakes up.
+//   At most one event is in flight until the UI calls Acknowledge(), however many channels share it.
+// Usage on the UI thread, once per frame: wakeup.Acknowledge(), then Update()/Read() cells and Drain() queues.
+
+#include <SDL3/SDL_events.h>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Keep producer and consumer owned data on separate cache lines
+constexpr std::size_t CacheLineSize = 64;
+
+class ChannelWakeup {
+public:
+    // SDL event type used for wake ups, registered on first use
+    static std::uint32_t EventType() {
+        static const std::uint32_t type = SDL_RegisterEvents(1);
+        return type;
+    }
+
+    // Producer side, any thread
+    void Notify() {
+        if (pending.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+        SDL_Event event = {};
+        event.type = EventType();
+        event.user.data1 = this;
+        SDL_PushEvent(&event);
+    }
+
+    // UI side, before reading the channels: anything published afterwards triggers a new event.
+    // A read-modify-write, not a store: a plain store could sit in the store buffer while the UI reads the channels,
+    // and a producer that published meanwhile would still see pending == true, so its data would get no wakeup.
+    void Acknowledge() { pending.exchange(false, std::memory_order_acq_rel); }
+
+private:
+    std::atomic<bool> pending = false;
+};
+
+template<typename T>
+class LatestValue {
+public:
+    explicit LatestValue(ChannelWakeup* main_loop_wakeup = nullptr) : wakeup(main_loop_wakeup) {}
+
+    // Producer: fill Back() then Publish(), or Write() a complete value
+    T& Back() { return slots[back].value; }
+
+    void Publish() {
+        back = shared.exchange(static_cast<std::uint8_t>(back | Fresh), std::memory_order_acq_rel) & IndexMask;
+        if (wakeup != nullptr) {
+            wakeup->Notify();
+        }
+    }
+
+    void Write(T value) {
+        Back() = std::move(value);
+        Publish();
+    }
+
+    // Consumer: Update() swaps in the newest published value if there is one, Read() returns the current one
+    bool Update() {
+        if ((shared.load(std::memory_order_relaxed) & Fresh) == 0) {
+            return false;
+        }
+        front = shared.exchange(front, std::memory_order_acq_rel) & IndexMask;
+        return true;
+    }
+
+    const T& Read() const { return slots[front].value; }
+
+private:
+    static constexpr std::uint8_t IndexMask = 0x3;
+    static constexpr std::uint8_t Fresh = 0x4;
+
+    struct alignas(CacheLineSize) Slot {
+        T value{};
+    };
+
+    std::array<Slot, 3>                             slots;
+    alignas(CacheLineSize) std::atomic<std::uint8_t> shared = 1; // Index of the middle slot, plus Fresh once published
+    alignas(CacheLineSize) std::uint8_t             back = 2;    // Producer owned
+    alignas(CacheLineSize) std::uint8_t             front = 0;   // Consumer owned
+    ChannelWakeup*                                  wakeup;
+};
+
+template<typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(std::has_single_bit(Capacity), "Capacity must be a power of two");
+
+public:
+    explicit SpscQueue(ChannelWakeup* main_loop_wakeup = nullptr) : wakeup(main_loop_wakeup) {}
+
+    // Producer, a single thread
+    bool TryPush(T value) {
+        const std::size_t tail_index = tail.load(std::memory_order_relaxed);
+        if (tail_index - cachedHead == Capacity)
+        {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (tail_index - cachedHead == Capacity) {
+                return false;
+            }
+        }
+        items[tail_index & (Capacity - 1)] = std::move(value);
+        tail.store(tail_index + 1, std::memory_order_release);
+        if (wakeup != nullptr) {
+            wakeup->Notify();
+        }
+        return true;
+    }
+
+    // Consumer
+    bool TryPop(T& out) {
+        const std::size_t head_index = head.load(std::memory_order_relaxed);
+        if (head_index == cachedTail)
+        {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (head_index == cachedTail) {
+                return false;
+            }
+        }
+        out = std::move(items[head_index & (Capacity - 1)]);
+        head.store(head_index + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: pops at most max_count items into callback, returns how many
+    template<typename F>
+    std::size_t Drain(F&& callback, std::size_t max_count = Capacity) {
+        std::size_t count = 0;
+        T item;
+        while (count < max_count && TryPop(item)) {
+            callback(std::move(item));
+            count++;
+        }
+        return count;
+    }
+
+private:
+    alignas(CacheLineSize) std::atomic<std::size_t> head = 0;
+    alignas(CacheLineSize) std::size_t              cachedTail = 0; // Consumer's copy of tail
+    alignas(CacheLineSize) std::atomic<std::size_t> tail = 0;
+    alignas(CacheLineSize) std::size_t              cachedHead = 0; // Producer's copy of head
+    alignas(CacheLineSize) std::array<T, Capacity>  items;
+    ChannelWakeup*                                  wakeup;
+};
+
+// Bounded multi-producer queue with a sequence number per cell (D. Vyukov's design), single consumer
+template<typename T, std::size_t Capacity>
+class MpscQueue {
+    static_assert(std::has_single_bit(Capacity), "Capacity must be a power of two");
+
+public:
+    explicit MpscQueue(ChannelWakeup* main_loop_wakeup = nullptr) : wakeup(main_loop_wakeup) {
+        for (std::size_t i = 0; i < Capacity; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Producers, any thread
+    bool TryPush(T value) {
+        std::size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        for (;;)
+        {
+            cell = &cells[position & (Capacity - 1)];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+            if (difference < 0) {
+                return false; // Full
+            }
+            if (difference > 0) {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            } else if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        if (wakeup != nullptr) {
+            wakeup->Notify();
+        }
+        return true;
+    }
+
+    // Consumer
+    bool TryPop(T& out) {
+        Cell& cell = cells[dequeuePosition & (Capacity - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != dequeuePosition + 1) {
+            return false;
+        }
+        out = std::move(cell.value);
+        cell.sequence.store(dequeuePosition + Capacity, std::memory_order_release);
+        dequeuePosition++;
+        return true;
+    }
+
+    // Consumer: pops at most max_count items into callback, returns how many
+    template<typename F>
+    std::size_t Drain(F&& callback, std::size_t max_count = Capacity) {
+        std::size_t count = 0;
+        T item;
+        while (count < max_count && TryPop(item)) {
+            callback(std::move(item));
+            count++;
+        }
+        return count;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T                        value{};
+    };
+
+    std::array<Cell, Capacity>                      cells;
+    alignas(CacheLineSize) std::atomic<std::size_t> enqueuePosition = 0;
+    alignas(CacheLineSize) std::size_t              dequeuePosition = 0; // Consumer owned
+    ChannelWakeup*                                  wakeup;
+};
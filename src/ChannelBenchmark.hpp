@@ -0,0 +1,144 @@
+#pragma once
+
+// Stress test and throughput benchmark of Channel.hpp, shared by the Feeds panel and tests/ChannelTest.cpp.
+// Producers push per-producer sequence numbers as fast as they can, the consumer checks that every
+// sequence arrives exactly once and in order. The triple buffer check looks for torn or older values.
+// Every loop checks the stop token: a stopped run returns early with valid == false.
+
+#include "Channel.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+struct ChannelBenchmarkResult {
+    bool          valid = false;
+    double        mpscOpsPerSecond = 0.0;
+    double        spscOpsPerSecond = 0.0;
+    double        latestWritesPerSecond = 0.0;
+    double        latestReadsPerSecond = 0.0;
+    std::uint64_t errors = 0; // Lost, duplicated, reordered or torn values
+};
+
+inline ChannelBenchmarkResult RunChannelBenchmark(const std::stop_token& stop, std::uint64_t items_per_producer = 1'000'000, std::chrono::milliseconds latest_duration = std::chrono::milliseconds(250))
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr std::uint32_t Producers = 4;
+    ChannelBenchmarkResult result;
+
+    {
+        auto queue = std::make_unique<MpscQueue<std::uint64_t, 4096>>();
+        const auto start = Clock::now();
+        std::vector<std::jthread> producers;
+        for (std::uint64_t producer = 0; producer < Producers; producer++)
+        {
+            producers.emplace_back([&queue, &stop, producer, items_per_producer]() {
+                for (std::uint64_t i = 0; i < items_per_producer; i++) {
+                    while (!queue->TryPush((producer << 32U) | i)) {
+                        if (stop.stop_requested()) {
+                            return;
+                        }
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        std::array<std::uint64_t, Producers> expected = {};
+        std::uint64_t received = 0;
+        while (received < Producers * items_per_producer && !stop.stop_requested())
+        {
+            received += queue->Drain([&](std::uint64_t item) {
+                std::uint64_t& next = expected[item >> 32U];
+                if ((item & 0xFFFFFFFFU) != next) {
+                    result.errors++;
+                }
+                next = (item & 0xFFFFFFFFU) + 1;
+            });
+        }
+        producers.clear();
+        if (stop.stop_requested()) {
+            return result;
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        result.mpscOpsPerSecond = static_cast<double>(received) / seconds;
+    }
+
+    {
+        auto queue = std::make_unique<SpscQueue<std::uint64_t, 4096>>();
+        const std::uint64_t items = Producers * items_per_producer;
+        const auto start = Clock::now();
+        std::jthread producer([&queue, &stop, items]() {
+            for (std::uint64_t i = 0; i < items; i++) {
+                while (!queue->TryPush(i)) {
+                    if (stop.stop_requested()) {
+                        return;
+                    }
+                    std::this_thread::yield();
+                }
+            }
+        });
+        std::uint64_t expected = 0;
+        while (expected < items && !stop.stop_requested())
+        {
+            queue->Drain([&](std::uint64_t item) {
+                if (item != expected) {
+                    result.errors++;
+                }
+                expected = item + 1;
+            });
+        }
+        producer.join();
+        if (stop.stop_requested()) {
+            return result;
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        result.spscOpsPerSecond = static_cast<double>(items) / seconds;
+    }
+
+    {
+        struct Pair {
+            std::uint64_t a = 0;
+            std::uint64_t b = 0;
+        };
+        auto cell = std::make_unique<LatestValue<Pair>>();
+        std::atomic<std::uint64_t> writes = 0;
+        const auto start = Clock::now();
+        std::jthread producer([&cell, &writes](const std::stop_token& producer_stop) {
+            std::uint64_t i = 0;
+            while (!producer_stop.stop_requested())
+            {
+                i++;
+                cell->Back() = Pair{i, i};
+                cell->Publish();
+            }
+            writes.store(i, std::memory_order_relaxed);
+        });
+        std::uint64_t reads = 0;
+        std::uint64_t last = 0;
+        while (Clock::now() - start < latest_duration && !stop.stop_requested())
+        {
+            cell->Update();
+            const Pair& value = cell->Read();
+            if (value.a != value.b || value.a < last) {
+                result.errors++;
+            }
+            last = value.a;
+            reads++;
+        }
+        producer.request_stop();
+        producer.join();
+        if (stop.stop_requested()) {
+            return result;
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        result.latestWritesPerSecond = static_cast<double>(writes.load(std::memory_order_relaxed)) / seconds;
+        result.latestReadsPerSecond = static_cast<double>(reads) / seconds;
+    }
+
+    result.valid = true;
+    return result;
+}
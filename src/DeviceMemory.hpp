@@ -0,0 +1,681 @@
+#pragma once
+
+// Device memory sub-allocator owned by VulkanContext.
+// - General resources are placed in large per-memory-type blocks split with a buddy scheme,
+//   so creating a buffer or image costs a free-list pop instead of a vkAllocateMemory call.
+// - Requests larger than half a block get a dedicated vkAllocateMemory.
+// - Per-frame data goes through linear pools: each pool block is one host visible buffer, handed out in slices
+//   and reset once the frame's fence has signaled.
+// - Heap usage and budget are refreshed every frame through VK_EXT_memory_budget when the device supports it.
+// Not thread-safe: call from the render thread only.
+
+#include "imgui.h"
+#include "wrapper/ImGUI_wrapper.hpp"
+#include "wrapper/Vulkan_wrapper.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct DeviceMemoryBlock {
+    Vulkan::DeviceMemory memory = Vulkan::NULL_HANDLE;
+    Vulkan::DeviceSize   size = 0;
+    Vulkan::DeviceSize   used = 0;
+    std::uint32_t        memoryType = 0;
+    std::uint32_t        allocationCount = 0;
+    std::byte*           mapped = nullptr;
+    Vulkan::Buffer       buffer = Vulkan::NULL_HANDLE; // Linear blocks only, covers the whole block
+    std::vector<std::vector<Vulkan::DeviceSize>> freeLists; // Buddy free lists indexed by order, empty for linear blocks
+};
+
+struct DeviceAllocation {
+    Vulkan::DeviceMemory memory = Vulkan::NULL_HANDLE;
+    Vulkan::DeviceSize   offset = 0;
+    Vulkan::DeviceSize   size = 0;
+    void*                mapped = nullptr;  // Host pointer at offset, only for HOST_VISIBLE memory types
+    Vulkan::Buffer       buffer = Vulkan::NULL_HANDLE; // Transient allocations only, use with offset
+    std::uint32_t        memoryType = 0;
+    std::uint32_t        order = 0;         // Buddy order inside block
+    DeviceMemoryBlock*   block = nullptr;   // nullptr for dedicated allocations
+    bool                 transient = false; // Released by BeginFrame(), never by Free()
+};
+
+struct DeviceHeapStats {
+    Vulkan::DeviceSize budget = 0;
+    Vulkan::DeviceSize usage = 0;           // Process usage from VK_EXT_memory_budget, or blockBytes without it
+    Vulkan::DeviceSize blockBytes = 0;      // Everything this allocator obtained from vkAllocateMemory
+    Vulkan::DeviceSize allocatedBytes = 0;
+    Vulkan::DeviceSize freeBytes = 0;       // Unused space in general blocks
+    Vulkan::DeviceSize largestFreeRange = 0;
+    Vulkan::DeviceSize usedBlockFreeBytes = 0;  // Unused space in general blocks holding allocations
+    Vulkan::DeviceSize strandedBytes = 0;       // Part of it outside each block's largest free range
+    std::uint32_t      blockCount = 0;
+    std::uint32_t      allocationCount = 0;
+    std::uint32_t      dedicatedCount = 0;
+    std::uint32_t      frameAllocations = 0;       // Allocate()/AllocateTransient() calls
+    std::uint32_t      frameFrees = 0;             // Free() calls and transient allocations released by BeginFrame()
+    std::uint32_t      frameDeviceAllocations = 0; // vkAllocateMemory calls (new blocks and dedicated allocations)
+
+    // Per block, so empty blocks kept for reuse do not count as fragmented space
+    [[nodiscard]] float Fragmentation() const {
+        if (usedBlockFreeBytes == 0) {
+            return 0.0F;
+        }
+        return static_cast<float>(strandedBytes) / static_cast<float>(usedBlockFreeBytes);
+    }
+};
+
+class DeviceMemoryAllocator {
+public:
+    static constexpr Vulkan::DeviceSize DefaultBlockSize = Vulkan::DeviceSize{64} << 20U;
+    static constexpr Vulkan::DeviceSize LinearBlockSize = Vulkan::DeviceSize{4} << 20U;
+    static constexpr std::uint32_t      MinNodeShift = 8; // Smallest buddy node is 256 bytes
+    static constexpr float              BudgetWarningRatio = 0.9F;
+    static constexpr std::uint32_t      TransientBufferUsage = static_cast<std::uint32_t>(VK_BUFFER_USAGE_TRANSFER_SRC_BIT) | static_cast<std::uint32_t>(VK_BUFFER_USAGE_TRANSFER_DST_BIT) |
+                                                               static_cast<std::uint32_t>(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT) | static_cast<std::uint32_t>(VK_BUFFER_USAGE_INDEX_BUFFER_BIT) |
+                                                               static_cast<std::uint32_t>(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+
+    // Called once per frame for every heap whose usage is above BudgetWarningRatio of its budget,
+    // after empty blocks of that heap were released. The application is expected to evict its own resources.
+    using BudgetCallback = std::function<void(std::uint32_t heap, const DeviceHeapStats& stats)>;
+
+    void Init(Vulkan::Instance instance, Vulkan::PhysicalDevice physical_device, Vulkan::Device logical_device, const Vulkan::AllocationCallbacks* allocation_callbacks, bool memory_budget);
+    void Shutdown();
+
+    Vulkan::Result Allocate(const Vulkan::MemoryRequirements& requirements, Vulkan::MemoryPropertyFlags properties, DeviceAllocation& out);
+    // Slice of a host visible, coherent buffer (TransientBufferUsage), valid until BeginFrame(frame_index)
+    Vulkan::Result AllocateTransient(std::uint32_t frame_index, Vulkan::DeviceSize size, Vulkan::DeviceSize alignment, DeviceAllocation& out);
+    Vulkan::Result BindBuffer(Vulkan::Buffer buffer, Vulkan::MemoryPropertyFlags properties, DeviceAllocation& out);
+    Vulkan::Result BindImage(Vulkan::Image image, Vulkan::MemoryPropertyFlags properties, DeviceAllocation& out);
+    void Free(DeviceAllocation& allocation);
+
+    void BeginFrame(std::uint32_t frame_index);
+    void UpdateBudget();
+    Vulkan::DeviceSize TrimEmptyBlocks(std::uint32_t heap);
+
+    void SetBudgetCallback(BudgetCallback callback) { budgetCallback = std::move(callback); }
+    [[nodiscard]] bool HasMemoryBudget() const { return memoryBudget; }
+    [[nodiscard]] const std::vector<DeviceHeapStats>& HeapStats() const { return heapStats; }
+    void ShowStatsWindow(bool* p_open) const;
+
+private:
+    Vulkan::PhysicalDevice                    physicalDevice = Vulkan::NULL_HANDLE;
+    Vulkan::Device                            device = Vulkan::NULL_HANDLE;
+    const Vulkan::AllocationCallbacks*        allocator = nullptr;
+    Vulkan::PhysicalDeviceMemoryProperties    memoryProperties = {};
+    Vulkan::DeviceSize                        bufferImageGranularity = 1;
+    PFN_vkGetPhysicalDeviceMemoryProperties2KHR getMemoryProperties2 = nullptr;
+    bool                                      memoryBudget = false;
+    BudgetCallback                            budgetCallback;
+
+    std::vector<std::vector<std::unique_ptr<DeviceMemoryBlock>>> blocks;     // Indexed by memory type
+    std::vector<std::vector<std::unique_ptr<DeviceMemoryBlock>>> framePools; // Indexed by frame index
+    std::vector<Vulkan::DeviceSize>                             blockSizes;      // Indexed by memory type
+    std::vector<Vulkan::DeviceSize>                             dedicatedBytes;  // Indexed by memory type
+    std::vector<std::uint32_t>                                  dedicatedCounts; // Indexed by memory type
+    std::vector<std::uint32_t>                                  frameAllocations; // Indexed by heap
+    std::vector<std::uint32_t>                                  frameFrees;       // Indexed by heap
+    std::vector<std::uint32_t>                                  frameDeviceAllocations; // Indexed by heap
+    std::vector<DeviceHeapStats>                                heapStats;        // Indexed by heap
+
+    static constexpr Vulkan::DeviceSize NodeSize(std::uint32_t order) { return Vulkan::DeviceSize{1} << (order + MinNodeShift); }
+    static bool BuddyAllocate(DeviceMemoryBlock& block, std::uint32_t order, Vulkan::DeviceSize& offset);
+    static void BuddyFree(DeviceMemoryBlock& block, std::uint32_t order, Vulkan::DeviceSize offset);
+
+    [[nodiscard]] std::uint32_t FindMemoryType(std::uint32_t type_bits, Vulkan::MemoryPropertyFlags properties) const;
+    [[nodiscard]] std::uint32_t HeapOf(std::uint32_t memory_type) const { return memoryProperties.memoryTypes[memory_type].heapIndex; }
+    Vulkan::Result AllocateDeviceMemory(std::uint32_t memory_type, Vulkan::DeviceSize size, Vulkan::DeviceMemory& memory, std::byte*& mapped);
+    void FreeDeviceMemory(Vulkan::DeviceMemory memory);
+    Vulkan::Result CreateBlock(std::uint32_t memory_type, Vulkan::DeviceSize size, std::unique_ptr<DeviceMemoryBlock>& out);
+    Vulkan::Result CreateLinearBlock(Vulkan::DeviceSize size, std::unique_ptr<DeviceMemoryBlock>& out);
+};
+
+inline void DeviceMemoryAllocator::Init(Vulkan::Instance instance, Vulkan::PhysicalDevice physical_device, Vulkan::Device logical_device, const Vulkan::AllocationCallbacks* allocation_callbacks, bool memory_budget)
+{
+    physicalDevice = physical_device;
+    device = logical_device;
+    allocator = allocation_callbacks;
+
+    vkGetPhysicalDeviceMemoryProperties(physical_device, &memoryProperties);
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties(physical_device, &properties);
+    bufferImageGranularity = std::max<Vulkan::DeviceSize>(properties.limits.bufferImageGranularity, 1);
+
+    // The instance is created without VkApplicationInfo (Vulkan 1.0), so the KHR entry point is the one to use
+    if (memory_budget) {
+        getMemoryProperties2 = std::bit_cast<PFN_vkGetPhysicalDeviceMemoryProperties2KHR>(vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceMemoryProperties2KHR"));
+    }
+    memoryBudget = getMemoryProperties2 != nullptr;
+
+    // Keep at least 8 blocks per heap so small heaps (e.g. host visible BAR) are not exhausted by one block
+    blocks.resize(memoryProperties.memoryTypeCount);
+    blockSizes.resize(memoryProperties.memoryTypeCount);
+    dedicatedBytes.assign(memoryProperties.memoryTypeCount, 0);
+    dedicatedCounts.assign(memoryProperties.memoryTypeCount, 0);
+    for (std::uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+        const Vulkan::DeviceSize heap_size = memoryProperties.memoryHeaps[HeapOf(i)].size;
+        blockSizes[i] = std::clamp(std::bit_floor(heap_size / 8), NodeSize(0), DefaultBlockSize);
+    }
+    frameAllocations.assign(memoryProperties.memoryHeapCount, 0);
+    frameFrees.assign(memoryProperties.memoryHeapCount, 0);
+    frameDeviceAllocations.assign(memoryProperties.memoryHeapCount, 0);
+    heapStats.assign(memoryProperties.memoryHeapCount, DeviceHeapStats{});
+    UpdateBudget();
+}
+
+inline void DeviceMemoryAllocator::Shutdown()
+{
+    for (auto& type_blocks : blocks) {
+        for (auto& block : type_blocks) {
+            IM_ASSERT(block->allocationCount == 0 && "Device allocations leaked");
+            FreeDeviceMemory(block->memory);
+        }
+        type_blocks.clear();
+    }
+    for (auto& pool : framePools) {
+        for (auto& block : pool)
+        {
+            vkDestroyBuffer(device, block->buffer, allocator);
+            FreeDeviceMemory(block->memory);
+        }
+        pool.clear();
+    }
+    for (const std::uint32_t count : dedicatedCounts) {
+        IM_ASSERT(count == 0 && "Dedicated device allocations leaked");
+        (void)count;
+    }
+}
+
+inline std::uint32_t DeviceMemoryAllocator::FindMemoryType(std::uint32_t type_bits, Vulkan::MemoryPropertyFlags properties) const
+{
+    for (std::uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+        if ((type_bits & (1U << i)) != 0 && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+    return static_cast<std::uint32_t>(-1);
+}
+
+inline Vulkan::Result DeviceMemoryAllocator::AllocateDeviceMemory(std::uint32_t memory_type, Vulkan::DeviceSize size, Vulkan::DeviceMemory& memory, std::byte*& mapped)
+{
+    Vulkan::MemoryAllocateInfo info = {};
+    info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    info.allocationSize = size;
+    info.memoryTypeIndex = memory_type;
+    Vulkan::Result err = vkAllocateMemory(device, &info, allocator, &memory);
+    if (err == VK_ERROR_OUT_OF_DEVICE_MEMORY || err == VK_ERROR_OUT_OF_HOST_MEMORY) {
+        // Give cached empty blocks back to the driver and retry once
+        if (TrimEmptyBlocks(HeapOf(memory_type)) > 0) {
+            err = vkAllocateMemory(device, &info, allocator, &memory);
+        }
+    }
+    if (err != VK_SUCCESS) {
+        return err;
+    }
+
+    mapped = nullptr;
+    if ((memoryProperties.memoryTypes[memory_type].propertyFlags & static_cast<std::uint32_t>(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) != 0)
+    {
+        void* data = nullptr;
+        err = vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &data);
+        if (err != VK_SUCCESS)
+        {
+            vkFreeMemory(device, memory, allocator);
+            memory = Vulkan::NULL_HANDLE;
+            return err;
+        }
+        mapped = static_cast<std::byte*>(data);
+    }
+    frameDeviceAllocations[HeapOf(memory_type)]++;
+    return VK_SUCCESS;
+}
+
+inline void DeviceMemoryAllocator::FreeDeviceMemory(Vulkan::DeviceMemory memory)
+{
+    // Mapped memory is implicitly unmapped by vkFreeMemory
+    vkFreeMemory(device, memory, allocator);
+}
+
+inline Vulkan::Result DeviceMemoryAllocator::CreateBlock(std::uint32_t memory_type, Vulkan::DeviceSize size, std::unique_ptr<DeviceMemoryBlock>& out)
+{
+    auto block = std::make_unique<DeviceMemoryBlock>();
+    Vulkan::Result err = AllocateDeviceMemory(memory_type, size, block->memory, block->mapped);
+    if (err != VK_SUCCESS) {
+        return err;
+    }
+    block->size = size;
+    block->memoryType = memory_type;
+    const auto max_order = static_cast<std::uint32_t>(std::countr_zero(size)) - MinNodeShift;
+    block->freeLists.resize(max_order + 1);
+    block->freeLists[max_order].push_back(0);
+    out = std::move(block);
+    return VK_SUCCESS;
+}
+
+inline Vulkan::Result DeviceMemoryAllocator::CreateLinearBlock(Vulkan::DeviceSize size, std::unique_ptr<DeviceMemoryBlock>& out)
+{
+    auto block = std::make_unique<DeviceMemoryBlock>();
+    Vulkan::BufferCreateInfo info = {};
+    info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    info.size = size;
+    info.usage = TransientBufferUsage;
+    info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    Vulkan::Result err = vkCreateBuffer(device, &info, allocator, &block->buffer);
+    if (err != VK_SUCCESS) {
+        return err;
+    }
+
+    Vulkan::MemoryRequirements requirements = {};
+    vkGetBufferMemoryRequirements(device, block->buffer, &requirements);
+    const std::uint32_t memory_type = FindMemoryType(requirements.memoryTypeBits, static_cast<std::uint32_t>(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) | static_cast<std::uint32_t>(VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+    err = memory_type == static_cast<std::uint32_t>(-1) ? VK_ERROR_FEATURE_NOT_PRESENT : AllocateDeviceMemory(memory_type, requirements.size, block->memory, block->mapped);
+    if (err == VK_SUCCESS)
+    {
+        err = vkBindBufferMemory(device, block->buffer, block->memory, 0);
+        if (err != VK_SUCCESS) {
+            FreeDeviceMemory(block->memory);
+        }
+    }
+    if (err != VK_SUCCESS)
+    {
+        vkDestroyBuffer(device, block->buffer, allocator);
+        return err;
+    }
+    block->size = size;
+    block->memoryType = memory_type;
+    out = std::move(block);
+    return VK_SUCCESS;
+}
+
+inline bool DeviceMemoryAllocator::BuddyAllocate(DeviceMemoryBlock& block, std::uint32_t order, Vulkan::DeviceSize& offset)
+{
+    auto level = static_cast<std::size_t>(order);
+    while (level < block.freeLists.size() && block.freeLists[level].empty()) {
+        level++;
+    }
+    if (level >= block.freeLists.size()) {
+        return false;
+    }
+    offset = block.freeLists[level].back();
+    block.freeLists[level].pop_back();
+
+    // Split down to the requested order, keeping the upper halves free
+    while (level > order)
+    {
+        level--;
+        block.freeLists[level].push_back(offset + NodeSize(static_cast<std::uint32_t>(level)));
+    }
+    return true;
+}
+
+inline void DeviceMemoryAllocator::BuddyFree(DeviceMemoryBlock& block, std::uint32_t order, Vulkan::DeviceSize offset)
+{
+    // Merge with the buddy as long as it is free
+    while (order + 1 < block.freeLists.size())
+    {
+        auto& list = block.freeLists[order];
+        auto buddy = std::ranges::find(list, offset ^ NodeSize(order));
+        if (buddy == list.end()) {
+            break;
+        }
+        *buddy = list.back();
+        list.pop_back();
+        offset &= ~NodeSize(order);
+        order++;
+    }
+    block.freeLists[order].push_back(offset);
+}
+
+inline Vulkan::Result DeviceMemoryAllocator::Allocate(const Vulkan::MemoryRequirements& requirements, Vulkan::MemoryPropertyFlags properties, DeviceAllocation& out)
+{
+    const std::uint32_t memory_type = FindMemoryType(requirements.memoryTypeBits, properties);
+    if (memory_type == static_cast<std::uint32_t>(-1)) {
+        return VK_ERROR_FEATURE_NOT_PRESENT;
+    }
+    out = DeviceAllocation{};
+    out.memoryType = memory_type;
+    out.size = requirements.size;
+
+    // Buddy nodes are aligned to their own size, so rounding up to the alignment is enough.
+    // bufferImageGranularity is folded in so linear and optimal resources never share a page.
+    const Vulkan::DeviceSize alignment = std::max(requirements.alignment, bufferImageGranularity);
+    const Vulkan::DeviceSize node_size = std::bit_ceil(std::max({requirements.size, alignment, NodeSize(0)}));
+    if (node_size > blockSizes[memory_type] / 2)
+    {
+        std::byte* mapped = nullptr;
+        Vulkan::Result err = AllocateDeviceMemory(memory_type, requirements.size, out.memory, mapped);
+        if (err != VK_SUCCESS) {
+            return err;
+        }
+        out.mapped = mapped;
+        dedicatedBytes[memory_type] += requirements.size;
+        dedicatedCounts[memory_type]++;
+        frameAllocations[HeapOf(memory_type)]++;
+        return VK_SUCCESS;
+    }
+
+    const auto order = static_cast<std::uint32_t>(std::countr_zero(node_size)) - MinNodeShift;
+    Vulkan::DeviceSize offset = 0;
+    DeviceMemoryBlock* target = nullptr;
+    for (auto& block : blocks[memory_type]) {
+        if (BuddyAllocate(*block, order, offset)) {
+            target = block.get();
+            break;
+        }
+    }
+    if (target == nullptr)
+    {
+        std::unique_ptr<DeviceMemoryBlock> block;
+        Vulkan::Result err = CreateBlock(memory_type, blockSizes[memory_type], block);
+        if (err != VK_SUCCESS) {
+            return err;
+        }
+        target = block.get();
+        blocks[memory_type].push_back(std::move(block));
+        BuddyAllocate(*target, order, offset);
+    }
+
+    target->used += node_size;
+    target->allocationCount++;
+    out.memory = target->memory;
+    out.offset = offset;
+    out.order = order;
+    out.block = target;
+    out.mapped = target->mapped != nullptr ? target->mapped + offset : nullptr;
+    frameAllocations[HeapOf(memory_type)]++;
+    return VK_SUCCESS;
+}
+
+inline Vulkan::Result DeviceMemoryAllocator::AllocateTransient(std::uint32_t frame_index, Vulkan::DeviceSize size, Vulkan::DeviceSize alignment, DeviceAllocation& out)
+{
+    if (frame_index >= framePools.size()) {
+        framePools.resize(frame_index + 1);
+    }
+    auto& pool = framePools[frame_index];
+
+    alignment = std::bit_ceil(std::max<Vulkan::DeviceSize>(alignment, 1));
+    DeviceMemoryBlock* target = nullptr;
+    Vulkan::DeviceSize offset = 0;
+    for (auto& block : pool)
+    {
+        offset = (block->used + alignment - 1) & ~(alignment - 1);
+        if (offset + size <= block->size)
+        {
+            target = block.get();
+            break;
+        }
+    }
+    if (target == nullptr)
+    {
+        std::unique_ptr<DeviceMemoryBlock> block;
+        Vulkan::Result err = CreateLinearBlock(std::max(LinearBlockSize, std::bit_ceil(size)), block);
+        if (err != VK_SUCCESS) {
+            return err;
+        }
+        target = block.get();
+        pool.push_back(std::move(block));
+        offset = 0;
+    }
+
+    target->used = offset + size;
+    target->allocationCount++;
+    out = DeviceAllocation{};
+    out.memory = target->memory;
+    out.buffer = target->buffer;
+    out.offset = offset;
+    out.size = size;
+    out.memoryType = target->memoryType;
+    out.mapped = target->mapped + offset;
+    out.transient = true;
+    frameAllocations[HeapOf(target->memoryType)]++;
+    return VK_SUCCESS;
+}
+
+inline Vulkan::Result DeviceMemoryAllocator::BindBuffer(Vulkan::Buffer buffer, Vulkan::MemoryPropertyFlags properties, DeviceAllocation& out)
+{
+    Vulkan::MemoryRequirements requirements = {};
+    vkGetBufferMemoryRequirements(device, buffer, &requirements);
+    Vulkan::Result err = Allocate(requirements, properties, out);
+    if (err != VK_SUCCESS) {
+        return err;
+    }
+    err = vkBindBufferMemory(device, buffer, out.memory, out.offset);
+    if (err != VK_SUCCESS) {
+        Free(out);
+    }
+    return err;
+}
+
+inline Vulkan::Result DeviceMemoryAllocator::BindImage(Vulkan::Image image, Vulkan::MemoryPropertyFlags properties, DeviceAllocation& out)
+{
+    Vulkan::MemoryRequirements requirements = {};
+    vkGetImageMemoryRequirements(device, image, &requirements);
+    Vulkan::Result err = Allocate(requirements, properties, out);
+    if (err != VK_SUCCESS) {
+        return err;
+    }
+    err = vkBindImageMemory(device, image, out.memory, out.offset);
+    if (err != VK_SUCCESS) {
+        Free(out);
+    }
+    return err;
+}
+
+inline void DeviceMemoryAllocator::Free(DeviceAllocation& allocation)
+{
+    if (allocation.memory == Vulkan::NULL_HANDLE || allocation.transient) {
+        return;
+    }
+    frameFrees[HeapOf(allocation.memoryType)]++;
+    if (allocation.block == nullptr)
+    {
+        FreeDeviceMemory(allocation.memory);
+        dedicatedBytes[allocation.memoryType] -= allocation.size;
+        dedicatedCounts[allocation.memoryType]--;
+    }
+    else
+    {
+        // Empty blocks are kept around for reuse until TrimEmptyBlocks() runs under budget pressure
+        BuddyFree(*allocation.block, allocation.order, allocation.offset);
+        allocation.block->used -= NodeSize(allocation.order);
+        allocation.block->allocationCount--;
+    }
+    allocation = DeviceAllocation{};
+}
+
+inline void DeviceMemoryAllocator::BeginFrame(std::uint32_t frame_index)
+{
+    if (frame_index >= framePools.size()) {
+        return;
+    }
+    for (auto& block : framePools[frame_index])
+    {
+        frameFrees[HeapOf(block->memoryType)] += block->allocationCount;
+        block->used = 0;
+        block->allocationCount = 0;
+    }
+}
+
+inline Vulkan::DeviceSize DeviceMemoryAllocator::TrimEmptyBlocks(std::uint32_t heap)
+{
+    Vulkan::DeviceSize released = 0;
+    for (std::uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+    {
+        if (HeapOf(i) != heap) {
+            continue;
+        }
+        std::erase_if(blocks[i], [&](const std::unique_ptr<DeviceMemoryBlock>& block) {
+            if (block->allocationCount != 0) {
+                return false;
+            }
+            released += block->size;
+            FreeDeviceMemory(block->memory);
+            return true;
+        });
+    }
+    return released;
+}
+
+inline void DeviceMemoryAllocator::UpdateBudget()
+{
+    for (DeviceHeapStats& stats : heapStats) {
+        stats = DeviceHeapStats{};
+    }
+
+    for (std::uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+    {
+        DeviceHeapStats& stats = heapStats[HeapOf(i)];
+        for (const auto& block : blocks[i])
+        {
+            const Vulkan::DeviceSize largest = [&]() -> Vulkan::DeviceSize {
+                for (auto order = block->freeLists.size(); order-- > 0;) {
+                    if (!block->freeLists[order].empty()) {
+                        return NodeSize(static_cast<std::uint32_t>(order));
+                    }
+                }
+                return 0;
+            }();
+            stats.blockBytes += block->size;
+            stats.allocatedBytes += block->used;
+            stats.freeBytes += block->size - block->used;
+            stats.largestFreeRange = std::max(stats.largestFreeRange, largest);
+            if (block->allocationCount != 0)
+            {
+                stats.usedBlockFreeBytes += block->size - block->used;
+                stats.strandedBytes += block->size - block->used - largest;
+            }
+            stats.allocationCount += block->allocationCount;
+            stats.blockCount++;
+        }
+        stats.blockBytes += dedicatedBytes[i];
+        stats.allocatedBytes += dedicatedBytes[i];
+        stats.allocationCount += dedicatedCounts[i];
+        stats.dedicatedCount += dedicatedCounts[i];
+    }
+    for (const auto& pool : framePools) {
+        for (const auto& block : pool)
+        {
+            DeviceHeapStats& stats = heapStats[HeapOf(block->memoryType)];
+            stats.blockBytes += block->size;
+            stats.allocatedBytes += block->used;
+            stats.allocationCount += block->allocationCount;
+            stats.blockCount++;
+        }
+    }
+
+    Vulkan::PhysicalDeviceMemoryBudgetPropertiesEXT budget = {};
+    if (memoryBudget)
+    {
+        budget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+        Vulkan::PhysicalDeviceMemoryProperties2 properties = {};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+        properties.pNext = &budget;
+        getMemoryProperties2(physicalDevice, &properties);
+    }
+
+    for (std::uint32_t heap = 0; heap < memoryProperties.memoryHeapCount; heap++)
+    {
+        DeviceHeapStats& stats = heapStats[heap];
+        if (memoryBudget)
+        {
+            stats.budget = budget.heapBudget[heap];
+            stats.usage = budget.heapUsage[heap];
+        }
+        else
+        {
+            // Same heuristic as the extension-less path of most allocators: 80% of the heap
+            stats.budget = memoryProperties.memoryHeaps[heap].size / 10 * 8;
+            stats.usage = stats.blockBytes;
+        }
+        stats.frameAllocations = std::exchange(frameAllocations[heap], 0);
+        stats.frameFrees = std::exchange(frameFrees[heap], 0);
+        stats.frameDeviceAllocations = std::exchange(frameDeviceAllocations[heap], 0);
+
+        if (stats.budget > 0 && static_cast<float>(stats.usage) >= static_cast<float>(stats.budget) * BudgetWarningRatio)
+        {
+            const Vulkan::DeviceSize released = TrimEmptyBlocks(heap);
+            stats.blockBytes -= released;
+            stats.freeBytes -= std::min(stats.freeBytes, released);
+            stats.usage -= std::min(stats.usage, released);
+            if (budgetCallback) {
+                budgetCallback(heap, stats);
+            }
+        }
+    }
+}
+
+static std::string FormatDeviceSize(Vulkan::DeviceSize size)
+{
+    if (size >= (Vulkan::DeviceSize{1} << 30U)) {
+        return std::format("{:.2f} GiB", static_cast<double>(size) / static_cast<double>(Vulkan::DeviceSize{1} << 30U));
+    }
+    if (size >= (Vulkan::DeviceSize{1} << 20U)) {
+        return std::format("{:.1f} MiB", static_cast<double>(size) / static_cast<double>(Vulkan::DeviceSize{1} << 20U));
+    }
+    return std::format("{:.1f} KiB", static_cast<double>(size) / 1024.0);
+}
+
+inline void DeviceMemoryAllocator::ShowStatsWindow(bool* p_open) const
+{
+    if (!ImGui::Begin("Device Memory", p_open))
+    {
+        ImGui::End();
+        return;
+    }
+    ImGui::Text(std::format("VK_EXT_memory_budget: {}", memoryBudget ? "enabled" : "unavailable (estimated budget)"));
+
+    constexpr auto table_flags = static_cast<ImGuiTableFlags>(static_cast<std::uint32_t>(ImGuiTableFlags_Borders) | static_cast<std::uint32_t>(ImGuiTableFlags_RowBg) | static_cast<std::uint32_t>(ImGuiTableFlags_SizingFixedFit));
+    if (ImGui::BeginTable("heaps", 9, table_flags))
+    {
+        ImGui::TableSetupColumn("Heap");
+        ImGui::TableSetupColumn("Usage / Budget", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Blocks");
+        ImGui::TableSetupColumn("Allocated");
+        ImGui::TableSetupColumn("Allocations");
+        ImGui::TableSetupColumn("Dedicated");
+        ImGui::TableSetupColumn("Fragmentation");
+        ImGui::TableSetupColumn("Allocs/Frees per frame");
+        ImGui::TableSetupColumn("vkAllocateMemory per frame");
+        ImGui::TableHeadersRow();
+        for (std::uint32_t heap = 0; heap < heapStats.size(); heap++)
+        {
+            const DeviceHeapStats& stats = heapStats[heap];
+            const bool device_local = (memoryProperties.memoryHeaps[heap].flags & static_cast<std::uint32_t>(VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)) != 0;
+            const float ratio = stats.budget > 0 ? static_cast<float>(stats.usage) / static_cast<float>(stats.budget) : 0.0F;
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text(std::format("{}{}", heap, device_local ? " (device)" : " (host)"));
+            ImGui::TableNextColumn();
+            if (ratio >= BudgetWarningRatio) {
+                ImGui::PushStyleColor(ImGuiCol_PlotHistogram, ImVec4(0.90F, 0.30F, 0.20F, 1.00F));
+            }
+            ImGui::ProgressBar(ratio, ImVec2(-1.0F, 0.0F), std::format("{} / {}", FormatDeviceSize(stats.usage), FormatDeviceSize(stats.budget)).c_str());
+            if (ratio >= BudgetWarningRatio) {
+                ImGui::PopStyleColor();
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text(std::format("{} ({})", stats.blockCount, FormatDeviceSize(stats.blockBytes)));
+            ImGui::TableNextColumn();
+            ImGui::Text(FormatDeviceSize(stats.allocatedBytes));
+            ImGui::TableNextColumn();
+            ImGui::Text(std::format("{}", stats.allocationCount));
+            ImGui::TableNextColumn();
+            ImGui::Text(std::format("{}", stats.dedicatedCount));
+            ImGui::TableNextColumn();
+            ImGui::Text(std::format("{:.1f}%", stats.Fragmentation() * 100.0F));
+            ImGui::TableNextColumn();
+            ImGui::Text(std::format("{} / {}", stats.frameAllocations, stats.frameFrees));
+            ImGui::TableNextColumn();
+            ImGui::Text(std::format("{}", stats.frameDeviceAllocations));
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
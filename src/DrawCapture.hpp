@@ -0,0 +1,888 @@
+#pragma once
+
+// Draw data capture and deterministic replay, for repeatable renderer benchmarks.
+// - Capture (--capture <file>): after ImGui::Render() and before FrameRender(), the ImDrawData of every viewport is
+//   appended to a binary stream: vertex/index buffers, draw commands (clip rect, texture, offsets, element count) and
+//   display metrics. The font atlas pixels are stored (as RGBA32) in the frames where the atlas was created or updated.
+// - Each buffer is delta-compressed against the same draw list of the previous frame: unchanged buffers cost one byte,
+//   changed ones are stored as XOR runs against the previous content, whichever is smaller than the raw bytes.
+// - Replay (--replay <file>): the window is resized to the captured display size, the captured atlas is uploaded, and
+//   the stream is fed back through FrameRender() at maximum speed without building any UI, then frame statistics are printed.
+// The stream is written in native byte order and ImDrawVert/ImDrawIdx layout; the header rejects mismatching builds.
+// Only the main viewport is replayed, other viewports are decoded (to keep the delta state) and skipped.
+// Textures are replayed as the font atlas: other texture IDs are session handles that cannot survive a restart.
+// Known callbacks (ImDrawCallback_ResetRenderState, SolidColorPipeline) are replayed, other callbacks are skipped.
+
+#include "DeviceMemory.hpp"
+#include "frame.hpp"
+#include "imgui.h"
+#include "imgui_impl_vulkan.h"
+#include "SolidColorPipeline.hpp"
+#include "VulkanContext.hpp"
+#include "wrapper/ImGUI_wrapper.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <print>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace DrawCapture {
+    constexpr std::uint32_t Magic = 0x43444D49; // "IMDC"
+    constexpr std::uint32_t Version = 3;
+    constexpr std::size_t   MinMatchRun = 4;    // Shorter matching runs are cheaper to keep inside a literal
+    // Smallest encodings, to bound counts read from the stream by the bytes left in the frame record
+    constexpr std::size_t   MinViewportBytes = sizeof(ImGuiID) + 1 + (3 * sizeof(ImVec2)) + 1;
+    constexpr std::size_t   MinListBytes = 3;   // Three StreamMode::Same bytes
+
+    enum class StreamMode : std::uint8_t {
+        Same = 0,   // Identical to the previous frame
+        Raw = 1,    // Plain bytes
+        XorRuns = 2 // Alternating (matching byte count, literal count, literal XOR previous) runs
+    };
+
+    enum FrameFlags : std::uint8_t {
+        FrameFlags_None = 0,
+        FrameFlags_Atlas = 1 << 0 // Font atlas width, height and RGBA32 pixel stream follow
+    };
+
+    enum ViewportFlags : std::uint8_t {
+        ViewportFlags_None = 0,
+        ViewportFlags_Main = 1 << 0
+    };
+
+    enum CommandType : std::uint32_t {
+        CommandType_Texture = 0,          // Draw with a session texture, replayed with the font atlas
+        CommandType_FontAtlas = 1,        // Draw with the font atlas
+        CommandType_ResetRenderState = 2, // ImDrawCallback_ResetRenderState
+        CommandType_SolidColor = 3,       // SolidColorPipeline callback
+        CommandType_UnknownCallback = 4   // Other user callback, skipped on replay
+    };
+
+    // Serialized ImDrawCmd, callbacks are stored as their CommandType
+    struct Command {
+        ImVec4        ClipRect;
+        std::uint64_t TexID;
+        std::uint32_t Type;
+        std::uint32_t VtxOffset;
+        std::uint32_t IdxOffset;
+        std::uint32_t ElemCount;
+    };
+
+    // Previous content of one draw list, the reference for delta compression on both sides
+    struct ListState {
+        std::vector<std::uint8_t> vtx;
+        std::vector<std::uint8_t> idx;
+        std::vector<std::uint8_t> cmd;
+    };
+
+    inline void WriteVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<std::uint8_t>(value | 0x80U));
+            value >>= 7U;
+        }
+        out.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    template<typename T>
+    void WritePod(std::vector<std::uint8_t>& out, const T& value) {
+        const auto* bytes = std::bit_cast<const std::uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    template<typename T>
+    std::span<const std::uint8_t> Bytes(const ImVector<T>& vector) {
+        return {std::bit_cast<const std::uint8_t*>(vector.Data), static_cast<std::size_t>(vector.Size) * sizeof(T)};
+    }
+
+    inline std::uint8_t PreviousByte(std::span<const std::uint8_t> previous, std::size_t i) {
+        return i < previous.size() ? previous[i] : 0;
+    }
+
+    inline void EncodeXorRuns(std::span<const std::uint8_t> previous, std::span<const std::uint8_t> current, std::vector<std::uint8_t>& out) {
+        std::size_t i = 0;
+        while (i < current.size())
+        {
+            std::size_t matching = 0;
+            while (i + matching < current.size() && PreviousByte(previous, i + matching) == current[i + matching]) {
+                matching++;
+            }
+            i += matching;
+
+            // The literal ends where a long enough matching run starts
+            std::size_t end = i;
+            std::size_t run = 0;
+            while (end < current.size())
+            {
+                run = PreviousByte(previous, end) == current[end] ? run + 1 : 0;
+                end++;
+                if (run == MinMatchRun)
+                {
+                    end -= MinMatchRun;
+                    break;
+                }
+            }
+            WriteVarint(out, matching);
+            WriteVarint(out, end - i);
+            for (; i < end; i++) {
+                out.push_back(current[i] ^ PreviousByte(previous, i));
+            }
+        }
+    }
+} // namespace DrawCapture
+
+class DrawDataWriter {
+public:
+    void Open(const std::string& path);
+    [[nodiscard]] bool IsOpen() const { return file.is_open(); }
+    void WriteFrame(const ImVector<ImGuiViewport*>& viewports);
+    void Close();
+
+private:
+    std::ofstream                                                 file;
+    std::unordered_map<ImGuiID, std::vector<DrawCapture::ListState>> previous;
+    std::vector<std::uint8_t>                                     buffer;
+    std::vector<std::uint8_t>                                     commands;
+    std::vector<std::uint8_t>                                     atlasPixels;   // Previous atlas, the delta reference
+    std::vector<std::uint8_t>                                     atlasRgba;
+    int                                                           atlasUniqueId = -1;
+    std::uint64_t                                                 atlasCount = 0;
+    std::uint64_t                                                 frameCount = 0;
+    std::uint64_t                                                 rawBytes = 0;
+    std::uint64_t                                                 writtenBytes = 0;
+
+    void WriteStream(std::vector<std::uint8_t>& reference, std::span<const std::uint8_t> current);
+    void WriteAtlas(const ImTextureData& atlas);
+};
+
+inline void DrawDataWriter::Open(const std::string& path)
+{
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error(std::format("Cannot open capture file {}", path));
+    }
+    buffer.clear();
+    DrawCapture::WritePod(buffer, DrawCapture::Magic);
+    DrawCapture::WritePod(buffer, DrawCapture::Version);
+    DrawCapture::WritePod(buffer, static_cast<std::uint32_t>(sizeof(ImDrawVert)));
+    DrawCapture::WritePod(buffer, static_cast<std::uint32_t>(sizeof(ImDrawIdx)));
+    DrawCapture::WritePod(buffer, static_cast<std::uint32_t>(sizeof(DrawCapture::Command)));
+    file.write(std::bit_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+}
+
+inline void DrawDataWriter::WriteStream(std::vector<std::uint8_t>& reference, std::span<const std::uint8_t> current)
+{
+    rawBytes += current.size();
+    if (reference.size() == current.size() && std::ranges::equal(reference, current))
+    {
+        buffer.push_back(static_cast<std::uint8_t>(DrawCapture::StreamMode::Same));
+        return;
+    }
+
+    const std::size_t header = buffer.size();
+    buffer.push_back(static_cast<std::uint8_t>(DrawCapture::StreamMode::XorRuns));
+    DrawCapture::WriteVarint(buffer, current.size());
+    const std::size_t payload = buffer.size();
+    DrawCapture::EncodeXorRuns(reference, current, buffer);
+    if (buffer.size() - payload >= current.size())
+    {
+        buffer.resize(payload);
+        buffer[header] = static_cast<std::uint8_t>(DrawCapture::StreamMode::Raw);
+        buffer.insert(buffer.end(), current.begin(), current.end());
+    }
+    reference.assign(current.begin(), current.end());
+}
+
+inline void DrawDataWriter::WriteAtlas(const ImTextureData& atlas)
+{
+    // Always stored as RGBA32 so the replay has a single upload path, Alpha8 expands to white like in the backend
+    const std::size_t pixel_count = static_cast<std::size_t>(atlas.Width) * static_cast<std::size_t>(atlas.Height);
+    atlasRgba.resize(pixel_count * 4);
+    if (atlas.Format == ImTextureFormat_Alpha8)
+    {
+        for (std::size_t i = 0; i < pixel_count; i++)
+        {
+            atlasRgba[(i * 4) + 0] = 0xFF;
+            atlasRgba[(i * 4) + 1] = 0xFF;
+            atlasRgba[(i * 4) + 2] = 0xFF;
+            atlasRgba[(i * 4) + 3] = atlas.Pixels[i];
+        }
+    }
+    else {
+        std::memcpy(atlasRgba.data(), atlas.Pixels, atlasRgba.size());
+    }
+    DrawCapture::WritePod(buffer, static_cast<std::uint32_t>(atlas.Width));
+    DrawCapture::WritePod(buffer, static_cast<std::uint32_t>(atlas.Height));
+    WriteStream(atlasPixels, atlasRgba);
+    atlasUniqueId = atlas.UniqueID;
+    atlasCount++;
+}
+
+// Call between ImGui::Render() and FrameRender(): the atlas status still tells whether the backend is about to upload it
+inline void DrawDataWriter::WriteFrame(const ImVector<ImGuiViewport*>& viewports)
+{
+    buffer.clear();
+    const ImTextureData* atlas = ImGui::GetIO().Fonts->TexData;
+    const bool atlas_changed = atlas != nullptr && atlas->Pixels != nullptr &&
+        (atlas->UniqueID != atlasUniqueId || atlas->Status == ImTextureStatus_WantCreate || atlas->Status == ImTextureStatus_WantUpdates);
+    buffer.push_back(atlas_changed ? DrawCapture::FrameFlags_Atlas : DrawCapture::FrameFlags_None);
+    if (atlas_changed) {
+        WriteAtlas(*atlas);
+    }
+
+    std::uint32_t viewport_count = 0;
+    for (const ImGuiViewport* viewport : viewports) {
+        if (viewport->DrawData != nullptr && viewport->DrawData->Valid) {
+            viewport_count++;
+        }
+    }
+    DrawCapture::WriteVarint(buffer, viewport_count);
+
+    const ImGuiViewport* main_viewport = ImGui::GetMainViewport();
+    for (const ImGuiViewport* viewport : viewports)
+    {
+        const ImDrawData* draw_data = viewport->DrawData;
+        if (draw_data == nullptr || !draw_data->Valid) {
+            continue;
+        }
+        DrawCapture::WritePod(buffer, viewport->ID);
+        buffer.push_back(viewport == main_viewport ? DrawCapture::ViewportFlags_Main : DrawCapture::ViewportFlags_None);
+        DrawCapture::WritePod(buffer, draw_data->DisplayPos);
+        DrawCapture::WritePod(buffer, draw_data->DisplaySize);
+        DrawCapture::WritePod(buffer, draw_data->FramebufferScale);
+        DrawCapture::WriteVarint(buffer, static_cast<std::uint32_t>(draw_data->CmdListsCount));
+
+        std::vector<DrawCapture::ListState>& lists = previous[viewport->ID];
+        lists.resize(static_cast<std::size_t>(draw_data->CmdListsCount));
+        for (int n = 0; n < draw_data->CmdListsCount; n++)
+        {
+            const ImDrawList* draw_list = draw_data->CmdLists[n];
+            commands.clear();
+            for (const ImDrawCmd& cmd : draw_list->CmdBuffer)
+            {
+                DrawCapture::Command command = {};
+                command.ClipRect = cmd.ClipRect;
+                if (cmd.UserCallback == ImDrawCallback_ResetRenderState) {
+                    command.Type = DrawCapture::CommandType_ResetRenderState;
+                } else if (cmd.UserCallback == SolidColorPipeline::BindCallback()) {
+                    command.Type = DrawCapture::CommandType_SolidColor;
+                } else if (cmd.UserCallback != nullptr) {
+                    command.Type = DrawCapture::CommandType_UnknownCallback;
+                }
+                else
+                {
+                    // Compare texture data, not IDs: textures created this frame get their ID in FrameRender()
+                    command.TexID = static_cast<std::uint64_t>(cmd.TexRef._TexData != nullptr ? cmd.TexRef._TexData->TexID : cmd.TexRef._TexID);
+                    command.Type = cmd.TexRef._TexData != nullptr && cmd.TexRef._TexData == atlas ? DrawCapture::CommandType_FontAtlas : DrawCapture::CommandType_Texture;
+                }
+                command.VtxOffset = cmd.VtxOffset;
+                command.IdxOffset = cmd.IdxOffset;
+                command.ElemCount = cmd.ElemCount;
+                DrawCapture::WritePod(commands, command);
+            }
+
+            DrawCapture::ListState& state = lists[static_cast<std::size_t>(n)];
+            WriteStream(state.vtx, DrawCapture::Bytes(draw_list->VtxBuffer));
+            WriteStream(state.idx, DrawCapture::Bytes(draw_list->IdxBuffer));
+            WriteStream(state.cmd, commands);
+        }
+    }
+
+    // Frame records are length-prefixed so a reader can skip or stop cleanly at a truncated tail
+    std::vector<std::uint8_t> length;
+    DrawCapture::WriteVarint(length, buffer.size());
+    file.write(std::bit_cast<const char*>(length.data()), static_cast<std::streamsize>(length.size()));
+    file.write(std::bit_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    writtenBytes += length.size() + buffer.size();
+    frameCount++;
+}
+
+inline void DrawDataWriter::Close()
+{
+    if (!file.is_open()) {
+        return;
+    }
+    file.close();
+    std::println("[capture] {} frames ({} font atlas versions), {:.2f} MiB of draw data written as {:.2f} MiB", frameCount, atlasCount, static_cast<double>(rawBytes) / (1024.0 * 1024.0), static_cast<double>(writtenBytes) / (1024.0 * 1024.0));
+}
+
+// Font atlas of the captured session, uploaded from the pixels stored in the stream.
+// The image is sub-allocated from device local memory, uploads are staged through a transient slice and wait for the queue.
+class ReplayAtlas {
+public:
+    void Init(const ImGui_ImplVulkanH_Window* wd);
+    void Upload(std::uint32_t atlas_width, std::uint32_t atlas_height, std::span<const std::uint8_t> pixels);
+    void Shutdown();
+    [[nodiscard]] ImTextureID TexID() const { return descriptorSet != Vulkan::NULL_HANDLE ? std::bit_cast<ImTextureID>(descriptorSet) : ImTextureID_Invalid; }
+    [[nodiscard]] std::uint32_t Uploads() const { return uploads; }
+    [[nodiscard]] double UploadMilliseconds() const { return uploadMs; }
+
+private:
+    const ImGui_ImplVulkanH_Window* mainWindow = nullptr;
+    Vulkan::CommandPool             commandPool = Vulkan::NULL_HANDLE;
+    Vulkan::CommandBuffer           commandBuffer = Vulkan::NULL_HANDLE;
+    Vulkan::Sampler                 sampler = Vulkan::NULL_HANDLE;
+    Vulkan::Image                   image = Vulkan::NULL_HANDLE;
+    Vulkan::ImageView               imageView = Vulkan::NULL_HANDLE;
+    Vulkan::DescriptorSet           descriptorSet = Vulkan::NULL_HANDLE;
+    DeviceAllocation                memory;
+    std::uint32_t                   width = 0;
+    std::uint32_t                   height = 0;
+    std::uint32_t                   uploads = 0;
+    double                          uploadMs = 0.0;
+
+    void CreateImage(std::uint32_t atlas_width, std::uint32_t atlas_height);
+    void DestroyImage();
+};
+
+inline void ReplayAtlas::Init(const ImGui_ImplVulkanH_Window* wd)
+{
+    mainWindow = wd;
+    Vulkan::CommandPoolCreateInfo pool_info = {};
+    pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    pool_info.queueFamilyIndex = VulkanContext::QueueFamily();
+    Vulkan::Result err = vkCreateCommandPool(VulkanContext::Device(), &pool_info, VulkanContext::Allocator(), &commandPool);
+    check_vk_result(err);
+
+    Vulkan::CommandBufferAllocateInfo buffer_info = {};
+    buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    buffer_info.commandPool = commandPool;
+    buffer_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    buffer_info.commandBufferCount = 1;
+    err = vkAllocateCommandBuffers(VulkanContext::Device(), &buffer_info, &commandBuffer);
+    check_vk_result(err);
+
+    // Same filtering as the backend's font sampler
+    Vulkan::SamplerCreateInfo sampler_info = {};
+    sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    sampler_info.magFilter = VK_FILTER_LINEAR;
+    sampler_info.minFilter = VK_FILTER_LINEAR;
+    sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_info.minLod = -1000;
+    sampler_info.maxLod = 1000;
+    sampler_info.maxAnisotropy = 1.0F;
+    err = vkCreateSampler(VulkanContext::Device(), &sampler_info, VulkanContext::Allocator(), &sampler);
+    check_vk_result(err);
+}
+
+inline void ReplayAtlas::CreateImage(std::uint32_t atlas_width, std::uint32_t atlas_height)
+{
+    Vulkan::ImageCreateInfo image_info = {};
+    image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    image_info.imageType = VK_IMAGE_TYPE_2D;
+    image_info.format = VK_FORMAT_R8G8B8A8_UNORM;
+    image_info.extent = {atlas_width, atlas_height, 1};
+    image_info.mipLevels = 1;
+    image_info.arrayLayers = 1;
+    image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    image_info.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    Vulkan::Result err = vkCreateImage(VulkanContext::Device(), &image_info, VulkanContext::Allocator(), &image);
+    check_vk_result(err);
+    err = VulkanContext::MemoryAllocator().BindImage(image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, memory);
+    check_vk_result(err);
+
+    Vulkan::ImageViewCreateInfo view_info = {};
+    view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    view_info.image = image;
+    view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view_info.format = VK_FORMAT_R8G8B8A8_UNORM;
+    view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    view_info.subresourceRange.levelCount = 1;
+    view_info.subresourceRange.layerCount = 1;
+    err = vkCreateImageView(VulkanContext::Device(), &view_info, VulkanContext::Allocator(), &imageView);
+    check_vk_result(err);
+
+    descriptorSet = ImGui_ImplVulkan_AddTexture(sampler, imageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    width = atlas_width;
+    height = atlas_height;
+}
+
+inline void ReplayAtlas::DestroyImage()
+{
+    if (image == Vulkan::NULL_HANDLE) {
+        return;
+    }
+    ImGui_ImplVulkan_RemoveTexture(descriptorSet);
+    vkDestroyImageView(VulkanContext::Device(), imageView, VulkanContext::Allocator());
+    vkDestroyImage(VulkanContext::Device(), image, VulkanContext::Allocator());
+    VulkanContext::MemoryAllocator().Free(memory);
+    descriptorSet = Vulkan::NULL_HANDLE;
+    imageView = Vulkan::NULL_HANDLE;
+    image = Vulkan::NULL_HANDLE;
+    width = 0;
+    height = 0;
+}
+
+inline void ReplayAtlas::Upload(std::uint32_t atlas_width, std::uint32_t atlas_height, std::span<const std::uint8_t> pixels)
+{
+    const auto upload_start = std::chrono::steady_clock::now();
+
+    // Frames in flight may still sample the previous content
+    Vulkan::Result err = vkDeviceWaitIdle(VulkanContext::Device());
+    check_vk_result(err);
+    if (atlas_width != width || atlas_height != height)
+    {
+        DestroyImage();
+        CreateImage(atlas_width, atlas_height);
+    }
+
+    DeviceAllocation staging;
+    err = VulkanContext::MemoryAllocator().AllocateTransient(mainWindow->FrameIndex, pixels.size(), 4, staging);
+    check_vk_result(err);
+    std::memcpy(staging.mapped, pixels.data(), pixels.size());
+
+    err = vkResetCommandPool(VulkanContext::Device(), commandPool, 0);
+    check_vk_result(err);
+    Vulkan::CommandBufferBeginInfo begin_info = {};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags |= static_cast<std::uint32_t>(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    err = vkBeginCommandBuffer(commandBuffer, &begin_info);
+    check_vk_result(err);
+
+    Vulkan::ImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    Vulkan::BufferImageCopy region = {};
+    region.bufferOffset = staging.offset;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = {atlas_width, atlas_height, 1};
+    vkCmdCopyBufferToImage(commandBuffer, staging.buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    err = vkEndCommandBuffer(commandBuffer);
+    check_vk_result(err);
+    Vulkan::SubmitInfo submit_info = {};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &commandBuffer;
+    err = vkQueueSubmit(VulkanContext::Queue(), 1, &submit_info, VK_NULL_HANDLE);
+    check_vk_result(err);
+    err = vkQueueWaitIdle(VulkanContext::Queue());
+    check_vk_result(err);
+
+    uploads++;
+    uploadMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - upload_start).count();
+}
+
+inline void ReplayAtlas::Shutdown()
+{
+    DestroyImage();
+    vkDestroySampler(VulkanContext::Device(), sampler, VulkanContext::Allocator());
+    vkDestroyCommandPool(VulkanContext::Device(), commandPool, VulkanContext::Allocator());
+    sampler = Vulkan::NULL_HANDLE;
+    commandPool = Vulkan::NULL_HANDLE;
+    commandBuffer = Vulkan::NULL_HANDLE;
+}
+
+// Decoded frame, the draw lists are reused from frame to frame
+struct ReplayViewport {
+    ImGuiID                                  id = 0;
+    bool                                     main = false;
+    ImDrawData                               drawData;
+    std::vector<std::unique_ptr<ImDrawList>> lists;
+};
+
+class DrawDataReader {
+public:
+    void Open(const std::string& path);
+    // Decodes the next frame into viewports and uploads the font atlas when it changed, returns false at the end of the stream
+    bool ReadFrame(std::vector<ReplayViewport>& viewports, ReplayAtlas& atlas);
+    [[nodiscard]] std::uint64_t RemappedTextures() const { return remappedTextures; }
+    [[nodiscard]] std::uint64_t SkippedCallbacks() const { return skippedCallbacks; }
+
+private:
+    std::vector<std::uint8_t>                                      data;
+    std::size_t                                                    cursor = 0;
+    std::unordered_map<ImGuiID, std::vector<DrawCapture::ListState>> previous;
+    std::vector<std::uint8_t>                                      atlasPixels;
+    std::uint64_t                                                  remappedTextures = 0;
+    std::uint64_t                                                  skippedCallbacks = 0;
+
+    std::uint64_t ReadVarint();
+    void ReadBytes(void* out, std::size_t size);
+    template<typename T>
+    T ReadPod() {
+        T value{};
+        ReadBytes(&value, sizeof(T));
+        return value;
+    }
+    void ReadStream(std::vector<std::uint8_t>& reference);
+    std::size_t ReadCount(std::size_t frame_end, std::size_t min_record_bytes);
+};
+
+inline void DrawDataReader::Open(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error(std::format("Cannot open capture file {}", path));
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    cursor = 0;
+    if (ReadPod<std::uint32_t>() != DrawCapture::Magic || ReadPod<std::uint32_t>() != DrawCapture::Version) {
+        throw std::runtime_error(std::format("{} is not a draw data capture", path));
+    }
+    if (ReadPod<std::uint32_t>() != sizeof(ImDrawVert) || ReadPod<std::uint32_t>() != sizeof(ImDrawIdx) || ReadPod<std::uint32_t>() != sizeof(DrawCapture::Command)) {
+        throw std::runtime_error(std::format("{} was captured with a different ImDrawVert/ImDrawIdx layout", path));
+    }
+}
+
+inline void DrawDataReader::ReadBytes(void* out, std::size_t size)
+{
+    if (size > data.size() - cursor) {
+        throw std::runtime_error("Truncated draw data capture");
+    }
+    std::memcpy(out, data.data() + cursor, size);
+    cursor += size;
+}
+
+inline std::uint64_t DrawDataReader::ReadVarint()
+{
+    std::uint64_t value = 0;
+    for (std::uint32_t shift = 0; shift < 64; shift += 7)
+    {
+        const auto byte = ReadPod<std::uint8_t>();
+        value |= static_cast<std::uint64_t>(byte & 0x7FU) << shift;
+        if ((byte & 0x80U) == 0) {
+            return value;
+        }
+    }
+    throw std::runtime_error("Malformed varint in draw data capture");
+}
+
+inline void DrawDataReader::ReadStream(std::vector<std::uint8_t>& reference)
+{
+    const auto mode = static_cast<DrawCapture::StreamMode>(ReadPod<std::uint8_t>());
+    if (mode == DrawCapture::StreamMode::Same) {
+        return;
+    }
+    const std::uint64_t size = ReadVarint();
+    if (size > data.size()) {
+        throw std::runtime_error("Malformed stream size in draw data capture");
+    }
+    if (mode == DrawCapture::StreamMode::Raw)
+    {
+        reference.resize(size);
+        ReadBytes(reference.data(), size);
+        return;
+    }
+    if (mode != DrawCapture::StreamMode::XorRuns) {
+        throw std::runtime_error("Unknown stream mode in draw data capture");
+    }
+
+    // Decode in place: bytes past the old size XOR against zero, like on the writer side
+    const std::size_t old_size = reference.size();
+    reference.resize(size);
+    std::fill(reference.begin() + static_cast<std::ptrdiff_t>(std::min<std::size_t>(old_size, size)), reference.end(), std::uint8_t{0});
+    std::size_t i = 0;
+    while (i < size)
+    {
+        const std::uint64_t matching = ReadVarint();
+        const std::uint64_t literal = ReadVarint();
+        if (matching + literal > size - i) {
+            throw std::runtime_error("Malformed run in draw data capture");
+        }
+        i += matching;
+        for (const std::size_t end = i + literal; i < end; i++) {
+            reference[i] ^= ReadPod<std::uint8_t>();
+        }
+    }
+}
+
+// Reads a record count, throws when that many records cannot fit in the rest of the frame
+inline std::size_t DrawDataReader::ReadCount(std::size_t frame_end, std::size_t min_record_bytes)
+{
+    const std::uint64_t count = ReadVarint();
+    const std::size_t remaining = cursor < frame_end ? frame_end - cursor : 0;
+    if (count > remaining / min_record_bytes) {
+        throw std::runtime_error(std::format("Record count {} exceeds the frame record in draw data capture", count));
+    }
+    return static_cast<std::size_t>(count);
+}
+
+inline bool DrawDataReader::ReadFrame(std::vector<ReplayViewport>& viewports, ReplayAtlas& atlas)
+{
+    if (cursor >= data.size()) {
+        return false;
+    }
+    const std::uint64_t frame_size = ReadVarint();
+    if (frame_size > data.size() - cursor) {
+        return false; // Truncated tail, e.g. the capturing process was killed
+    }
+    const std::size_t frame_start = cursor;
+    const std::size_t frame_end = frame_start + static_cast<std::size_t>(frame_size);
+
+    if ((ReadPod<std::uint8_t>() & DrawCapture::FrameFlags_Atlas) != 0)
+    {
+        const auto atlas_width = ReadPod<std::uint32_t>();
+        const auto atlas_height = ReadPod<std::uint32_t>();
+        ReadStream(atlasPixels);
+        if (atlas_width == 0 || atlas_height == 0 || atlasPixels.size() != static_cast<std::size_t>(atlas_width) * atlas_height * 4) {
+            throw std::runtime_error("Malformed font atlas in draw data capture");
+        }
+        atlas.Upload(atlas_width, atlas_height, atlasPixels);
+    }
+    if (atlas.TexID() == ImTextureID_Invalid) {
+        throw std::runtime_error("Draw data capture has no font atlas");
+    }
+    const ImTextureRef font_atlas(atlas.TexID());
+    const std::size_t viewport_count = ReadCount(frame_end, DrawCapture::MinViewportBytes);
+    viewports.resize(viewport_count);
+    for (ReplayViewport& viewport : viewports)
+    {
+        viewport.id = ReadPod<ImGuiID>();
+        viewport.main = (ReadPod<std::uint8_t>() & DrawCapture::ViewportFlags_Main) != 0;
+        ImDrawData& draw_data = viewport.drawData;
+        draw_data.Clear();
+        draw_data.DisplayPos = ReadPod<ImVec2>();
+        draw_data.DisplaySize = ReadPod<ImVec2>();
+        draw_data.FramebufferScale = ReadPod<ImVec2>();
+        draw_data.OwnerViewport = viewport.main ? ImGui::GetMainViewport() : nullptr;
+        draw_data.Textures = nullptr; // The captured font atlas is uploaded by ReplayAtlas, not by the backend
+        draw_data.Valid = true;
+
+        const std::size_t list_count = ReadCount(frame_end, DrawCapture::MinListBytes);
+        std::vector<DrawCapture::ListState>& lists = previous[viewport.id];
+        lists.resize(list_count);
+        while (viewport.lists.size() < list_count) {
+            viewport.lists.push_back(std::make_unique<ImDrawList>(ImGui::GetDrawListSharedData()));
+        }
+        for (std::size_t n = 0; n < list_count; n++)
+        {
+            DrawCapture::ListState& state = lists[n];
+            ReadStream(state.vtx);
+            ReadStream(state.idx);
+            ReadStream(state.cmd);
+            if (state.vtx.size() % sizeof(ImDrawVert) != 0 || state.idx.size() % sizeof(ImDrawIdx) != 0 || state.cmd.size() % sizeof(DrawCapture::Command) != 0) {
+                throw std::runtime_error("Malformed draw list in draw data capture");
+            }
+
+            ImDrawList* draw_list = viewport.lists[n].get();
+            draw_list->VtxBuffer.resize(static_cast<int>(state.vtx.size() / sizeof(ImDrawVert)));
+            draw_list->IdxBuffer.resize(static_cast<int>(state.idx.size() / sizeof(ImDrawIdx)));
+            std::memcpy(draw_list->VtxBuffer.Data, state.vtx.data(), state.vtx.size());
+            std::memcpy(draw_list->IdxBuffer.Data, state.idx.data(), state.idx.size());
+            draw_list->CmdBuffer.resize(0);
+            for (std::size_t offset = 0; offset < state.cmd.size(); offset += sizeof(DrawCapture::Command))
+            {
+                DrawCapture::Command command = {};
+                std::memcpy(&command, state.cmd.data() + offset, sizeof(command));
+                ImDrawCmd cmd;
+                switch (command.Type)
+                {
+                case DrawCapture::CommandType_Texture:
+                    remappedTextures++;
+                    break;
+                case DrawCapture::CommandType_FontAtlas:
+                    break;
+                case DrawCapture::CommandType_ResetRenderState:
+                    cmd.UserCallback = ImDrawCallback_ResetRenderState;
+                    break;
+                case DrawCapture::CommandType_SolidColor:
+                    cmd.UserCallback = SolidColorPipeline::BindCallback();
+                    break;
+                case DrawCapture::CommandType_UnknownCallback:
+                    skippedCallbacks++;
+                    continue;
+                default:
+                    throw std::runtime_error("Unknown command type in draw data capture");
+                }
+                cmd.ClipRect = command.ClipRect;
+                cmd.TexRef = font_atlas;
+                cmd.VtxOffset = command.VtxOffset;
+                cmd.IdxOffset = command.IdxOffset;
+                cmd.ElemCount = command.ElemCount;
+                draw_list->CmdBuffer.push_back(cmd);
+            }
+            draw_data.CmdLists.push_back(draw_list);
+            draw_data.TotalVtxCount += draw_list->VtxBuffer.Size;
+            draw_data.TotalIdxCount += draw_list->IdxBuffer.Size;
+        }
+        draw_data.CmdListsCount = static_cast<int>(list_count);
+    }
+    if (cursor != frame_end) {
+        throw std::runtime_error(std::format("Frame record size mismatch in draw data capture: {} bytes declared, {} decoded", frame_size, cursor - frame_start));
+    }
+    return true;
+}
+
+struct FrameStatistics {
+    double average = 0.0;
+    double minimum = 0.0;
+    double median = 0.0;
+    double p95 = 0.0;
+    double maximum = 0.0;
+};
+
+inline FrameStatistics ComputeFrameStatistics(std::vector<double> samples)
+{
+    FrameStatistics stats;
+    if (samples.empty()) {
+        return stats;
+    }
+    std::ranges::sort(samples);
+    double sum = 0.0;
+    for (const double sample : samples) {
+        sum += sample;
+    }
+    stats.average = sum / static_cast<double>(samples.size());
+    stats.minimum = samples.front();
+    stats.median = samples[samples.size() / 2];
+    stats.p95 = samples[std::min(samples.size() - 1, samples.size() * 95 / 100)];
+    stats.maximum = samples.back();
+    return stats;
+}
+
+inline void PrintFrameStatistics(const char* name, const std::vector<double>& samples)
+{
+    const FrameStatistics stats = ComputeFrameStatistics(samples);
+    std::println("[replay] {:<7} avg {:.3f} ms, min {:.3f}, median {:.3f}, p95 {:.3f}, max {:.3f} ({} frames)", name, stats.average, stats.minimum, stats.median, stats.p95, stats.maximum, samples.size());
+}
+
+// Resizes the window (and swap chain) to the display size of a captured frame, warns when the framebuffer differs
+static void ResizeToCapture(SDL_Window* window, ImGui_ImplVulkanH_Window* wd, const ImDrawData& draw_data)
+{
+    SDL_SetWindowSize(window, static_cast<int>(draw_data.DisplaySize.x), static_cast<int>(draw_data.DisplaySize.y));
+    SDL_SyncWindow(window);
+    ResizeSwapChain(window, wd);
+    const auto captured_width = static_cast<int>(draw_data.DisplaySize.x * draw_data.FramebufferScale.x);
+    const auto captured_height = static_cast<int>(draw_data.DisplaySize.y * draw_data.FramebufferScale.y);
+    if (wd->Width != captured_width || wd->Height != captured_height) {
+        std::println(stderr, "[replay] framebuffer is {}x{}, the capture was {}x{}: results are not comparable", wd->Width, wd->Height, captured_width, captured_height);
+    }
+}
+
+// Replays a capture through FrameRender()/FramePresent() as fast as the swap chain allows.
+// VulkanContext::UnlimitedFrameRate() should be set before the window was created so presentation does not wait for vsync.
+// The "frame" statistic is the CPU time of FrameRender()/FramePresent(), including swap chain acquire and fence waits.
+static int ReplayDrawData(SDL_Window* window, ImGui_ImplVulkanH_Window* wd, const std::string& path)
+{
+    DrawDataReader reader;
+    try {
+        reader.Open(path);
+    } catch (const std::runtime_error& e) {
+        std::println(stderr, "[replay] {}", e.what());
+        return 1;
+    }
+
+    GpuTimer timer;
+    timer.Init(true);
+    ReplayAtlas atlas;
+    atlas.Init(wd);
+    ImVec2 display_size(0.0F, 0.0F);
+    std::vector<double> decode_ms;
+    std::vector<double> render_ms;
+    std::vector<ReplayViewport> viewports;
+    std::uint64_t skipped_viewports = 0;
+    const auto replay_start = std::chrono::steady_clock::now();
+
+    bool done = false;
+    while (!done)
+    {
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_EVENT_QUIT || (event.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED && event.window.windowID == SDL_GetWindowID(window))) {
+                done = true;
+            }
+        }
+        const auto decode_start = std::chrono::steady_clock::now();
+        try {
+            if (!reader.ReadFrame(viewports, atlas)) {
+                break;
+            }
+        } catch (const std::runtime_error& e) {
+            std::println(stderr, "[replay] {}", e.what());
+            break;
+        }
+        const auto decode_end = std::chrono::steady_clock::now();
+
+        // Size the window from the captured frame before rendering it, outside the timed sections
+        for (const ReplayViewport& viewport : viewports)
+        {
+            const ImVec2 size = viewport.drawData.DisplaySize;
+            if (viewport.main && size.x > 0.0F && size.y > 0.0F && (size.x != display_size.x || size.y != display_size.y))
+            {
+                display_size = size;
+                ResizeToCapture(window, wd, viewport.drawData);
+            }
+        }
+        ResizeSwapChain(window, wd);
+
+        const auto render_start = std::chrono::steady_clock::now();
+        for (ReplayViewport& viewport : viewports)
+        {
+            if (!viewport.main) {
+                skipped_viewports++;
+                continue;
+            }
+            if (viewport.drawData.DisplaySize.x <= 0.0F || viewport.drawData.DisplaySize.y <= 0.0F) {
+                continue;
+            }
+            FrameRender(wd, &viewport.drawData, &timer);
+            FramePresent(wd);
+        }
+        const auto render_end = std::chrono::steady_clock::now();
+        decode_ms.push_back(std::chrono::duration<double, std::milli>(decode_end - decode_start).count());
+        render_ms.push_back(std::chrono::duration<double, std::milli>(render_end - render_start).count());
+    }
+
+    Vulkan::Result err = vkDeviceWaitIdle(VulkanContext::Device());
+    check_vk_result(err);
+    for (std::uint32_t i = 0; i < GpuTimer::MaxFrames; i++) {
+        timer.Collect(i);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - replay_start).count();
+
+    std::println("[replay] {} frames in {:.3f} s ({:.1f} FPS)", render_ms.size(), seconds, seconds > 0.0 ? static_cast<double>(render_ms.size()) / seconds : 0.0);
+    PrintFrameStatistics("decode", decode_ms);
+    PrintFrameStatistics("frame", render_ms);
+    if (timer.Supported()) {
+        PrintFrameStatistics("gpu", timer.Samples());
+    }
+    if (skipped_viewports > 0) {
+        std::println("[replay] {} secondary viewport frames skipped", skipped_viewports);
+    }
+    if (reader.RemappedTextures() > 0) {
+        std::println("[replay] {} draw commands used a non font-atlas texture, replayed with the font atlas", reader.RemappedTextures());
+    }
+    if (reader.SkippedCallbacks() > 0) {
+        std::println("[replay] {} unknown draw callbacks skipped", reader.SkippedCallbacks());
+    }
+    std::println("[replay] {} font atlas uploads, {:.3f} ms (included in decode)", atlas.Uploads(), atlas.UploadMilliseconds());
+    atlas.Shutdown();
+    timer.Shutdown();
+    return 0;
+}
@@ -0,0 +1,242 @@
+#pragma once
+
+// Example panel fed by background threads through Channel.hpp, plus the channel stress test and throughput
+// benchmark of ChannelBenchmark.hpp (run on a worker thread, results delivered back through a LatestValue).
+
+#include "Channel.hpp"
+#include "ChannelBenchmark.hpp"
+#include "imgui.h"
+#include "SolidColorPipeline.hpp"
+#include "wrapper/ImGUI_wrapper.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+class FeedPanel {
+public:
+    explicit FeedPanel(ChannelWakeup& wakeup);
+    FeedPanel(const FeedPanel&) = delete;
+    FeedPanel& operator=(const FeedPanel&) = delete;
+    FeedPanel(FeedPanel&&) = delete;
+    FeedPanel& operator=(FeedPanel&&) = delete;
+    ~FeedPanel() = default;
+
+    // UI thread, every frame before Update(): the demo producers only run while the panel is visible,
+    // so their wakeups only interrupt an idle main loop for data someone is looking at
+    void SetVisible(bool visible);
+    // UI thread, every frame (also when hidden, so queued events do not pile up)
+    void Update();
+    void Show(bool* p_open);
+    // Stops and joins all threads, call before SDL_Quit(): they push SDL events through the wakeup
+    void Stop();
+
+private:
+    struct Quote {
+        std::uint64_t sequence = 0;
+        double        value = 0.0;
+    };
+
+    struct FeedEvent {
+        std::uint32_t producer = 0;
+        std::uint64_t sequence = 0;
+    };
+
+    static constexpr std::size_t EventCapacity = 1024;
+    static constexpr std::size_t RecentEvents = 8;
+    static constexpr std::size_t QuoteHistory = 256;
+
+    LatestValue<Quote>                     quote;
+    MpscQueue<FeedEvent, EventCapacity>    events;
+    LatestValue<ChannelBenchmarkResult>    benchmark;
+    std::atomic<bool>                      benchmarkRunning = false;
+    std::atomic<std::uint64_t>             droppedEvents = 0;
+
+    // UI thread state
+    std::uint64_t          receivedEvents = 0;
+    std::vector<FeedEvent> recentEvents;
+    std::array<float, QuoteHistory> quoteHistory = {};
+    std::size_t            quoteHistoryOffset = 0;
+    std::size_t            quoteHistoryCount = 0;
+
+    void PlotQuoteHistory() const;
+    void StartProducers();
+    void StopProducers();
+
+    // Declared last: joined before the channels they write to are destroyed
+    std::jthread                quoteThread;
+    std::array<std::jthread, 2> eventThreads;
+    std::jthread                benchmarkThread;
+};
+
+inline FeedPanel::FeedPanel(ChannelWakeup& wakeup) :
+    quote(&wakeup), events(&wakeup), benchmark(&wakeup)
+{
+}
+
+// Sleeps for duration, returns early when stop is requested so hiding the panel does not wait for a producer
+inline void SleepUnlessStopped(const std::stop_token& stop, std::chrono::milliseconds duration)
+{
+    std::mutex mutex;
+    std::condition_variable_any stopped;
+    std::unique_lock lock(mutex);
+    stopped.wait_for(lock, stop, duration, []() { return false; });
+}
+
+inline void FeedPanel::SetVisible(bool visible)
+{
+    if (visible && !quoteThread.joinable()) {
+        StartProducers();
+    } else if (!visible && quoteThread.joinable()) {
+        StopProducers();
+    }
+}
+
+inline void FeedPanel::StartProducers()
+{
+    quoteThread = std::jthread([this](const std::stop_token& stop) {
+        for (std::uint64_t sequence = 1; !stop.stop_requested(); sequence++)
+        {
+            Quote& next = quote.Back();
+            next.sequence = sequence;
+            next.value = 100.0 + (10.0 * std::sin(static_cast<double>(sequence) * 0.01));
+            quote.Publish();
+            SleepUnlessStopped(stop, std::chrono::milliseconds(50));
+        }
+    });
+    for (std::uint32_t producer = 0; producer < eventThreads.size(); producer++)
+    {
+        eventThreads[producer] = std::jthread([this, producer](const std::stop_token& stop) {
+            for (std::uint64_t sequence = 0; !stop.stop_requested(); sequence++)
+            {
+                if (!events.TryPush(FeedEvent{producer, sequence})) {
+                    droppedEvents.fetch_add(1, std::memory_order_relaxed);
+                }
+                SleepUnlessStopped(stop, std::chrono::milliseconds(400 + (producer * 330)));
+            }
+        });
+    }
+}
+
+inline void FeedPanel::StopProducers()
+{
+    quoteThread.request_stop();
+    for (std::jthread& thread : eventThreads) {
+        thread.request_stop();
+    }
+    if (quoteThread.joinable()) {
+        quoteThread.join();
+    }
+    for (std::jthread& thread : eventThreads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+inline void FeedPanel::Stop()
+{
+    benchmarkThread.request_stop();
+    StopProducers();
+    if (benchmarkThread.joinable()) {
+        benchmarkThread.join();
+    }
+}
+
+inline void FeedPanel::Update()
+{
+    if (quote.Update())
+    {
+        quoteHistory[quoteHistoryOffset] = static_cast<float>(quote.Read().value);
+        quoteHistoryOffset = (quoteHistoryOffset + 1) % QuoteHistory;
+        quoteHistoryCount = std::min(quoteHistoryCount + 1, QuoteHistory);
+    }
+    benchmark.Update();
+    events.Drain([this](FeedEvent&& event) {
+        receivedEvents++;
+        if (recentEvents.size() == RecentEvents) {
+            recentEvents.erase(recentEvents.begin());
+        }
+        recentEvents.push_back(event);
+    });
+}
+
+inline void FeedPanel::Show(bool* p_open)
+{
+    if (!ImGui::Begin("Feeds", p_open))
+    {
+        ImGui::End();
+        return;
+    }
+
+    const Quote& latest = quote.Read();
+    ImGui::SeparatorText("Latest value (triple buffer)");
+    ImGui::Text(std::format("#{}  {:.3f}", latest.sequence, latest.value));
+    PlotQuoteHistory();
+
+    ImGui::SeparatorText("Events (MPSC queue)");
+    ImGui::Text(std::format("received {}, dropped {}", receivedEvents, droppedEvents.load(std::memory_order_relaxed)));
+    for (const FeedEvent& event : recentEvents) {
+        ImGui::Text(std::format("producer {} #{}", event.producer, event.sequence));
+    }
+
+    ImGui::SeparatorText("Stress test / benchmark");
+    const bool running = benchmarkRunning.load(std::memory_order_acquire);
+    ImGui::BeginDisabled(running);
+    if (ImGui::Button(running ? "Running..." : "Run"))
+    {
+        benchmarkRunning.store(true, std::memory_order_release);
+        benchmarkThread = std::jthread([this](const std::stop_token& stop) {
+            benchmark.Write(RunChannelBenchmark(stop));
+            benchmarkRunning.store(false, std::memory_order_release);
+        });
+    }
+    ImGui::EndDisabled();
+    const ChannelBenchmarkResult& result = benchmark.Read();
+    if (result.valid)
+    {
+        ImGui::Text(std::format("MPSC queue:   {:.1f} M items/s", result.mpscOpsPerSecond / 1e6));
+        ImGui::Text(std::format("SPSC queue:   {:.1f} M items/s", result.spscOpsPerSecond / 1e6));
+        ImGui::Text(std::format("Triple buffer: {:.1f} M writes/s, {:.1f} M reads/s", result.latestWritesPerSecond / 1e6, result.latestReadsPerSecond / 1e6));
+        ImGui::Text(std::format("Errors: {}", result.errors));
+    }
+    ImGui::End();
+}
+
+// Untextured plot of the received values, drawn with the solid color pipeline
+inline void FeedPanel::PlotQuoteHistory() const
+{
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const ImVec2 size(ImGui::GetContentRegionAvail().x, ImGui::GetTextLineHeight() * 4.0F);
+    ImGui::Dummy(size);
+
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    const ImDrawListFlags flags = SolidColorPipeline::Begin(draw_list);
+    draw_list->AddRectFilled(origin, ImVec2(origin.x + size.x, origin.y + size.y), ImGui::GetColorU32(ImGuiCol_FrameBg));
+    if (quoteHistoryCount >= 2)
+    {
+        std::array<float, QuoteHistory> values = {};
+        for (std::size_t i = 0; i < quoteHistoryCount; i++) {
+            values[i] = quoteHistory[(quoteHistoryOffset + QuoteHistory - quoteHistoryCount + i) % QuoteHistory];
+        }
+        const auto [low, high] = std::minmax_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(quoteHistoryCount));
+        const float range = std::max(*high - *low, 1e-3F);
+        std::array<ImVec2, QuoteHistory> points = {};
+        for (std::size_t i = 0; i < quoteHistoryCount; i++)
+        {
+            points[i].x = origin.x + (size.x * static_cast<float>(i) / static_cast<float>(quoteHistoryCount - 1));
+            points[i].y = origin.y + (size.y * (1.0F - ((values[i] - *low) / range)));
+        }
+        draw_list->AddPolyline(points.data(), static_cast<int>(quoteHistoryCount), ImGui::GetColorU32(ImGuiCol_PlotLines), ImDrawFlags_None, 1.5F);
+    }
+    SolidColorPipeline::End(draw_list, flags);
+}
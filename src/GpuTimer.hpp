@@ -0,0 +1,126 @@
+#pragma once
+
+// GPU time of each rendered frame, measured with timestamp queries around the frame's commands.
+// One query pair per swapchain frame slot. The results are copied on the GPU into a slice of the frame's
+// transient buffer (DeviceMemoryAllocator::AllocateTransient) and read from there once the slot's fence
+// has signaled, so collecting never stalls the CPU or calls into the driver.
+// The interval starts at COLOR_ATTACHMENT_OUTPUT, the stage FrameRender()'s submit waits on for the acquired
+// swapchain image, and ends when all commands of the frame have completed. It excludes the wait for the
+// presentation engine (up to a vsync interval under FIFO); vertex work that starts before the image is available
+// is not counted either.
+
+#include "VulkanContext.hpp"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <print>
+#include <vector>
+
+class GpuTimer {
+public:
+    static constexpr std::uint32_t MaxFrames = 16;
+
+    // keep_samples: record every frame for Samples(), otherwise only Latest() is kept
+    void Init(bool keep_samples = false);
+    void Shutdown();
+    [[nodiscard]] bool Supported() const { return queryPool != Vulkan::NULL_HANDLE; }
+
+    // Call after the fence of frame_index has signaled, before its transient memory is reset
+    void Collect(std::uint32_t frame_index);
+    void Begin(Vulkan::CommandBuffer command_buffer, std::uint32_t frame_index);
+    void End(Vulkan::CommandBuffer command_buffer, std::uint32_t frame_index);
+
+    // GPU milliseconds of every collected frame, in completion order
+    [[nodiscard]] const std::vector<double>& Samples() const { return samples; }
+    [[nodiscard]] double Latest() const { return latest; }
+
+private:
+    Vulkan::QueryPool           queryPool = Vulkan::NULL_HANDLE;
+    double                      periodMs = 0.0;
+    std::uint64_t               validMask = 0;
+    std::array<bool, MaxFrames> pending = {};
+    std::array<DeviceAllocation, MaxFrames> readback = {};
+    bool                        keepSamples = false;
+    double                      latest = 0.0;
+    std::vector<double>         samples;
+};
+
+inline void GpuTimer::Init(bool keep_samples)
+{
+    keepSamples = keep_samples;
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties(VulkanContext::PhysicalDevice(), &properties);
+    std::uint32_t family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(VulkanContext::PhysicalDevice(), &family_count, nullptr);
+    ImGui::Vector<VkQueueFamilyProperties> families;
+    families.resize(static_cast<std::int32_t>(family_count));
+    vkGetPhysicalDeviceQueueFamilyProperties(VulkanContext::PhysicalDevice(), &family_count, families.Data);
+
+    const std::uint32_t valid_bits = families[static_cast<std::int32_t>(VulkanContext::QueueFamily())].timestampValidBits;
+    if (valid_bits == 0 || properties.limits.timestampPeriod <= 0.0F)
+    {
+        std::println(stderr, "[vulkan] Timestamp queries not supported on the graphics queue, GPU time unavailable");
+        return;
+    }
+    periodMs = static_cast<double>(properties.limits.timestampPeriod) / 1e6;
+    validMask = valid_bits >= 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << valid_bits) - 1;
+
+    Vulkan::QueryPoolCreateInfo info = {};
+    info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    info.queryCount = MaxFrames * 2;
+    Vulkan::Result err = vkCreateQueryPool(VulkanContext::Device(), &info, VulkanContext::Allocator(), &queryPool);
+    check_vk_result(err);
+}
+
+inline void GpuTimer::Shutdown()
+{
+    if (queryPool != Vulkan::NULL_HANDLE) {
+        vkDestroyQueryPool(VulkanContext::Device(), queryPool, VulkanContext::Allocator());
+    }
+    queryPool = Vulkan::NULL_HANDLE;
+}
+
+inline void GpuTimer::Collect(std::uint32_t frame_index)
+{
+    if (!Supported() || frame_index >= MaxFrames || !pending[frame_index]) {
+        return;
+    }
+    std::array<std::uint64_t, 2> timestamps = {};
+    std::memcpy(timestamps.data(), readback[frame_index].mapped, sizeof(timestamps));
+    latest = static_cast<double>((timestamps[1] - timestamps[0]) & validMask) * periodMs;
+    if (keepSamples) {
+        samples.push_back(latest);
+    }
+    pending[frame_index] = false;
+}
+
+inline void GpuTimer::Begin(Vulkan::CommandBuffer command_buffer, std::uint32_t frame_index)
+{
+    if (!Supported() || frame_index >= MaxFrames) {
+        return;
+    }
+    vkCmdResetQueryPool(command_buffer, queryPool, frame_index * 2, 2);
+    // Inside the scope of the image acquired semaphore wait, a TOP_OF_PIPE timestamp could be written before it
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, queryPool, frame_index * 2);
+}
+
+inline void GpuTimer::End(Vulkan::CommandBuffer command_buffer, std::uint32_t frame_index)
+{
+    if (!Supported() || frame_index >= MaxFrames) {
+        return;
+    }
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, (frame_index * 2) + 1);
+
+    DeviceAllocation& slice = readback[frame_index];
+    if (VulkanContext::MemoryAllocator().AllocateTransient(frame_index, 2 * sizeof(std::uint64_t), sizeof(std::uint64_t), slice) != VK_SUCCESS) {
+        return;
+    }
+    vkCmdCopyQueryPoolResults(command_buffer, queryPool, frame_index * 2, 2, slice.buffer, slice.offset, sizeof(std::uint64_t), static_cast<std::uint32_t>(VK_QUERY_RESULT_64_BIT) | static_cast<std::uint32_t>(VK_QUERY_RESULT_WAIT_BIT));
+    Vulkan::MemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    pending[frame_index] = true;
+}
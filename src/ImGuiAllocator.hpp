@@ -0,0 +1,379 @@
+#pragma once
+
+// Allocator installed into Dear ImGui with ImGui::SetAllocatorFunctions().
+// - Requests up to MaxPooledSize are rounded to a size class and served from thread-local free lists.
+//   Empty lists refill in batches from a central per-class list (mutex protected), which carves new slabs from malloc.
+//   Slabs are kept for the lifetime of the process.
+// - Larger requests, and every request while the system allocator is selected, go straight to malloc.
+//   Each block carries a small header recording where it came from, so switching at runtime is safe.
+// - A per-frame arena (FrameAllocate/FrameFormat) serves transient UI thread data and is reset by BeginFrame().
+// Live/peak bytes and per-frame allocation counts are tracked in both modes, for comparison in ShowStatsWindow().
+
+#include "imgui.h"
+#include "wrapper/ImGUI_wrapper.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+struct ImGuiAllocatorStats {
+    std::int64_t  liveBytes = 0;
+    std::int64_t  liveAllocations = 0;
+    std::int64_t  peakBytes = 0;
+    std::uint64_t allocations = 0;
+    std::uint64_t frees = 0;
+    std::uint64_t allocatedBytes = 0;
+    std::uint64_t centralRefills = 0; // Thread cache misses that locked the central list
+    std::uint64_t arenaBytes = 0;
+    std::uint64_t reservedBytes = 0;  // Slab memory held by the pools
+};
+
+class ImGuiAllocator {
+public:
+    static constexpr std::size_t HeaderSize = 16; // Keeps returned blocks 16-byte aligned
+    static constexpr std::size_t MaxPooledSize = 32 * 1024;
+    static constexpr std::size_t SlabBytes = 64 * 1024;
+    static constexpr std::size_t ArenaChunkBytes = 64 * 1024;
+    static constexpr int         HistorySize = 120;
+
+    // Size classes: 16-byte steps up to 128, then 4 steps per power of two, block sizes include the header
+    static constexpr auto SizeClasses = []() constexpr {
+        std::array<std::uint32_t, 40> classes = {};
+        std::size_t count = 0;
+        for (std::uint32_t size = 32; size <= 128; size += 16) {
+            classes[count++] = size;
+        }
+        for (std::uint32_t base = 128; base < MaxPooledSize + HeaderSize; base *= 2) {
+            for (std::uint32_t step = 1; step <= 4 && count < classes.size(); step++) {
+                classes[count++] = base + (base / 4 * step);
+            }
+        }
+        return classes;
+    }();
+    static constexpr std::size_t ClassCount = SizeClasses.size();
+    static_assert(SizeClasses.back() >= MaxPooledSize + HeaderSize, "Size classes must cover MaxPooledSize");
+    static_assert(std::ranges::is_sorted(SizeClasses) && SizeClasses.front() > 0, "Size classes must be filled in order");
+
+    ImGuiAllocator() = delete;
+
+    // Must be called before ImGui::CreateContext()
+    static void Install() { ImGui::SetAllocatorFunctions(&Allocate, &Free, nullptr); }
+    static std::atomic<bool>& UseSystemAllocator() { return useSystemAllocator; }
+
+    static void* Allocate(std::size_t size, void* user_data);
+    static void Free(void* ptr, void* user_data);
+
+    // UI thread only, valid until the next BeginFrame()
+    static void* FrameAllocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+    template<typename... Args>
+    static const char* FrameFormat(std::format_string<Args...> fmt, Args&&... args);
+
+    // Once per frame, before ImGui::NewFrame(): publishes last frame's counters and resets the frame arena
+    static void BeginFrame();
+    static const ImGuiAllocatorStats& LastFrame() { return lastFrame; }
+    static void ShowStatsWindow(bool* p_open);
+
+private:
+    enum class Source : std::uint32_t {
+        Pool = 0x504F4F4C,  // "POOL"
+        System = 0x53595354 // "SYST"
+    };
+
+    struct Header {
+        Source        source;
+        std::uint32_t sizeClass;
+        std::uint64_t size;
+    };
+    static_assert(sizeof(Header) <= HeaderSize);
+
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    // Only used for the static central array, which is zero-initialized
+    struct CentralList {
+        std::mutex    mutex;
+        FreeNode*     head;
+        std::uint32_t count;
+    };
+
+    struct ThreadCache {
+        std::array<FreeNode*, ClassCount>     heads = {};
+        std::array<std::uint32_t, ClassCount> counts = {};
+        ThreadCache() = default;
+        ThreadCache(const ThreadCache&) = delete;
+        ThreadCache& operator=(const ThreadCache&) = delete;
+        ThreadCache(ThreadCache&&) = delete;
+        ThreadCache& operator=(ThreadCache&&) = delete;
+        ~ThreadCache();
+    };
+
+    static inline std::atomic<bool>                   useSystemAllocator = false; // Read by Allocate() on any thread
+    static inline std::array<CentralList, ClassCount> central;
+    static inline std::atomic<std::int64_t>           liveBytes = 0;
+    static inline std::atomic<std::int64_t>           liveAllocations = 0;
+    static inline std::atomic<std::int64_t>           peakBytes = 0;
+    static inline std::atomic<std::uint64_t>          allocations = 0;
+    static inline std::atomic<std::uint64_t>          frees = 0;
+    static inline std::atomic<std::uint64_t>          allocatedBytes = 0;
+    static inline std::atomic<std::uint64_t>          centralRefills = 0;
+    static inline std::atomic<std::uint64_t>          reservedBytes = 0;
+    static inline ImGuiAllocatorStats                          lastFrame;
+    static inline std::array<float, HistorySize>      allocationHistory = {};
+    static inline int                                 historyOffset = 0;
+
+    // Frame arena, UI thread only
+    static inline std::vector<std::unique_ptr<std::byte[]>> arenaChunks;
+    static inline std::size_t                             arenaChunk = 0;
+    static inline std::size_t                             arenaOffset = 0;
+    static inline std::uint64_t                           arenaBytes = 0;
+
+    static ThreadCache& Cache() {
+        static thread_local ThreadCache cache;
+        return cache;
+    }
+
+    static std::uint32_t SizeClassOf(std::size_t block_size) {
+        return static_cast<std::uint32_t>(std::ranges::lower_bound(SizeClasses, block_size) - SizeClasses.begin());
+    }
+
+    static std::uint32_t BatchSize(std::uint32_t size_class) {
+        return std::clamp<std::uint32_t>(static_cast<std::uint32_t>(SlabBytes / 4 / SizeClasses[size_class]), 4, 64);
+    }
+
+    static FreeNode* Refill(std::uint32_t size_class);
+    static void ReturnToCentral(ThreadCache& cache, std::uint32_t size_class, std::uint32_t count);
+};
+
+inline ImGuiAllocator::ThreadCache::~ThreadCache()
+{
+    for (std::uint32_t size_class = 0; size_class < ClassCount; size_class++) {
+        ReturnToCentral(*this, size_class, counts[size_class]);
+    }
+}
+
+inline ImGuiAllocator::FreeNode* ImGuiAllocator::Refill(std::uint32_t size_class)
+{
+    centralRefills.fetch_add(1, std::memory_order_relaxed);
+    ThreadCache& cache = Cache();
+    const std::uint32_t batch = BatchSize(size_class);
+    CentralList& list = central[size_class];
+    {
+        const std::scoped_lock lock(list.mutex);
+        for (std::uint32_t i = 0; i < batch && list.head != nullptr; i++)
+        {
+            FreeNode* node = list.head;
+            list.head = node->next;
+            list.count--;
+            node->next = cache.heads[size_class];
+            cache.heads[size_class] = node;
+            cache.counts[size_class]++;
+        }
+    }
+    if (cache.heads[size_class] != nullptr) {
+        return cache.heads[size_class];
+    }
+
+    // Central list empty: carve a new slab for this class
+    const std::size_t block_size = SizeClasses[size_class];
+    const std::size_t slab_bytes = block_size * batch;
+    auto* slab = static_cast<std::byte*>(std::malloc(slab_bytes));
+    if (slab == nullptr) {
+        return nullptr;
+    }
+    reservedBytes.fetch_add(slab_bytes, std::memory_order_relaxed);
+    for (std::uint32_t i = 0; i < batch; i++)
+    {
+        auto* node = std::bit_cast<FreeNode*>(slab + (i * block_size));
+        node->next = cache.heads[size_class];
+        cache.heads[size_class] = node;
+    }
+    cache.counts[size_class] += batch;
+    return cache.heads[size_class];
+}
+
+inline void ImGuiAllocator::ReturnToCentral(ThreadCache& cache, std::uint32_t size_class, std::uint32_t count)
+{
+    if (count == 0) {
+        return;
+    }
+    // Detach count nodes from the thread cache, then splice them in under the lock
+    FreeNode* first = cache.heads[size_class];
+    FreeNode* last = first;
+    for (std::uint32_t i = 1; i < count; i++) {
+        last = last->next;
+    }
+    cache.heads[size_class] = last->next;
+    cache.counts[size_class] -= count;
+
+    CentralList& list = central[size_class];
+    const std::scoped_lock lock(list.mutex);
+    last->next = list.head;
+    list.head = first;
+    list.count += count;
+}
+
+inline void* ImGuiAllocator::Allocate(std::size_t size, void* user_data)
+{
+    (void)user_data;
+    const std::size_t block_size = size + HeaderSize;
+    std::byte* block = nullptr;
+    Header header = {};
+    header.size = size;
+    if (!useSystemAllocator.load(std::memory_order_relaxed) && block_size <= MaxPooledSize + HeaderSize)
+    {
+        const std::uint32_t size_class = SizeClassOf(block_size);
+        ThreadCache& cache = Cache();
+        FreeNode* node = cache.heads[size_class];
+        if (node == nullptr) {
+            node = Refill(size_class);
+        }
+        if (node == nullptr) {
+            return nullptr;
+        }
+        cache.heads[size_class] = node->next;
+        cache.counts[size_class]--;
+        block = std::bit_cast<std::byte*>(node);
+        header.source = Source::Pool;
+        header.sizeClass = size_class;
+    }
+    else
+    {
+        block = static_cast<std::byte*>(std::malloc(block_size));
+        if (block == nullptr) {
+            return nullptr;
+        }
+        header.source = Source::System;
+    }
+    std::memcpy(block, &header, sizeof(header));
+
+    const auto bytes = static_cast<std::int64_t>(size);
+    const std::int64_t live = liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    std::int64_t peak = peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        // peak was reloaded, retry while live is still the higher value
+    }
+    liveAllocations.fetch_add(1, std::memory_order_relaxed);
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return block + HeaderSize;
+}
+
+inline void ImGuiAllocator::Free(void* ptr, void* user_data)
+{
+    (void)user_data;
+    if (ptr == nullptr) {
+        return;
+    }
+    std::byte* block = static_cast<std::byte*>(ptr) - HeaderSize;
+    Header header = {};
+    std::memcpy(&header, block, sizeof(header));
+    IM_ASSERT((header.source == Source::Pool || header.source == Source::System) && "Block not allocated by ImGuiAllocator");
+
+    liveBytes.fetch_sub(static_cast<std::int64_t>(header.size), std::memory_order_relaxed);
+    liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+    frees.fetch_add(1, std::memory_order_relaxed);
+
+    if (header.source == Source::System)
+    {
+        std::free(block);
+        return;
+    }
+    ThreadCache& cache = Cache();
+    auto* node = std::bit_cast<FreeNode*>(block);
+    node->next = cache.heads[header.sizeClass];
+    cache.heads[header.sizeClass] = node;
+    cache.counts[header.sizeClass]++;
+
+    // Keep thread caches bounded, blocks freed on another thread than their allocation would pile up otherwise
+    const std::uint32_t batch = BatchSize(header.sizeClass);
+    if (cache.counts[header.sizeClass] > batch * 2) {
+        ReturnToCentral(cache, header.sizeClass, batch);
+    }
+}
+
+inline void* ImGuiAllocator::FrameAllocate(std::size_t size, std::size_t alignment)
+{
+    for (;;)
+    {
+        if (arenaChunk < arenaChunks.size())
+        {
+            const std::size_t offset = (arenaOffset + alignment - 1) & ~(alignment - 1);
+            if (offset + size <= ArenaChunkBytes)
+            {
+                arenaOffset = offset + size;
+                arenaBytes += size;
+                return arenaChunks[arenaChunk].get() + offset;
+            }
+            arenaChunk++;
+            arenaOffset = 0;
+            continue;
+        }
+        if (size + alignment > ArenaChunkBytes) {
+            throw std::bad_alloc();
+        }
+        arenaChunks.push_back(std::make_unique<std::byte[]>(ArenaChunkBytes));
+    }
+}
+
+template<typename... Args>
+const char* ImGuiAllocator::FrameFormat(std::format_string<Args...> fmt, Args&&... args)
+{
+    const auto size = static_cast<std::size_t>(std::formatted_size(fmt, args...));
+    auto* text = static_cast<char*>(FrameAllocate(size + 1, 1));
+    *std::format_to(text, fmt, std::forward<Args>(args)...) = '\0';
+    return text;
+}
+
+inline void ImGuiAllocator::BeginFrame()
+{
+    lastFrame.liveBytes = liveBytes.load(std::memory_order_relaxed);
+    lastFrame.liveAllocations = liveAllocations.load(std::memory_order_relaxed);
+    lastFrame.peakBytes = peakBytes.load(std::memory_order_relaxed);
+    lastFrame.allocations = allocations.exchange(0, std::memory_order_relaxed);
+    lastFrame.frees = frees.exchange(0, std::memory_order_relaxed);
+    lastFrame.allocatedBytes = allocatedBytes.exchange(0, std::memory_order_relaxed);
+    lastFrame.centralRefills = centralRefills.exchange(0, std::memory_order_relaxed);
+    lastFrame.reservedBytes = reservedBytes.load(std::memory_order_relaxed);
+    lastFrame.arenaBytes = std::exchange(arenaBytes, 0);
+    arenaChunk = 0;
+    arenaOffset = 0;
+
+    allocationHistory[static_cast<std::size_t>(historyOffset)] = static_cast<float>(lastFrame.allocations);
+    historyOffset = (historyOffset + 1) % HistorySize;
+}
+
+inline void ImGuiAllocator::ShowStatsWindow(bool* p_open)
+{
+    if (!ImGui::Begin("ImGui Allocator", p_open))
+    {
+        ImGui::End();
+        return;
+    }
+    bool use_system_allocator = useSystemAllocator.load(std::memory_order_relaxed);
+    if (ImGui::Checkbox("Use system allocator", &use_system_allocator)) {
+        useSystemAllocator.store(use_system_allocator, std::memory_order_relaxed);
+    }
+    ImGui::SameLine();
+    ImGui::TextDisabled("(blocks keep their origin, switching is safe)");
+
+    const ImGuiAllocatorStats& stats = lastFrame;
+    ImGui::TextUnformatted(FrameFormat("Live: {:.1f} KiB in {} allocations", static_cast<double>(stats.liveBytes) / 1024.0, stats.liveAllocations));
+    ImGui::TextUnformatted(FrameFormat("Peak: {:.1f} KiB", static_cast<double>(stats.peakBytes) / 1024.0));
+    ImGui::TextUnformatted(FrameFormat("Last frame: {} allocations ({:.1f} KiB), {} frees", stats.allocations, static_cast<double>(stats.allocatedBytes) / 1024.0, stats.frees));
+    ImGui::TextUnformatted(FrameFormat("Pools: {:.1f} KiB reserved, {} central refills last frame", static_cast<double>(stats.reservedBytes) / 1024.0, stats.centralRefills));
+    ImGui::TextUnformatted(FrameFormat("Frame arena: {} bytes last frame", stats.arenaBytes));
+    ImGui::PlotLines("Allocations/frame", allocationHistory.data(), HistorySize, historyOffset, nullptr, 0.0F, FLT_MAX, ImVec2(0.0F, 60.0F));
+    ImGui::End();
+}
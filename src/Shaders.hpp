@@ -0,0 +1,96 @@
+#pragma once
+
+// Project-owned SPIR-V, compiled from src/shaders/*.{vert,frag} by glslc at build time (see CMakeLists.txt)
+// and embedded as constexpr word arrays, so no shader compiler or shader files are needed at runtime.
+// Variants are selected through specialization constants (SpecId). Pipelines built by the project pass a
+// VkSpecializationInfo with the unpatched ImGuiVertSpirv/ImGuiFragSpirv (see SolidColorPipeline.hpp).
+// The ImGui backend builds its pipelines itself and has no way to pass one, so its variants are baked at compile
+// time by rewriting the default value of the specialization constant in the SPIR-V:
+// - ImGuiVert / ImGuiVertLinearize: the backend's vertex shader, the latter for sRGB swapchains (--srgb)
+// - ImGuiFragTexture: the backend's fragment shader, used for everything ImGui draws
+
+#include "wrapper/Vulkan_wrapper.hpp"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace Shaders {
+    // Must match the constant_id values in src/shaders
+    namespace SpecId {
+        constexpr std::uint32_t SolidColor = 0;
+        constexpr std::uint32_t LinearizeColor = 1;
+    } // namespace SpecId
+
+    namespace Spirv {
+        constexpr std::size_t   HeaderWords = 5;
+        constexpr std::uint32_t OpSpecConstantTrue = 48;
+        constexpr std::uint32_t OpSpecConstantFalse = 49;
+        constexpr std::uint32_t OpSpecConstant = 50;
+        constexpr std::uint32_t OpDecorate = 71;
+        constexpr std::uint32_t DecorationSpecId = 1;
+    } // namespace Spirv
+
+    // Backend modules only. Returns a copy of code with the default value of the specialization constant spec_id set to value.
+    // Decorations precede constant declarations in a SPIR-V module, so a single pass is enough.
+    template<std::size_t N>
+    constexpr std::array<std::uint32_t, N> Specialize(std::array<std::uint32_t, N> code, std::uint32_t spec_id, std::uint32_t value) {
+        std::uint32_t target = 0;
+        bool patched = false;
+        for (std::size_t i = Spirv::HeaderWords; i < N;) {
+            const std::uint32_t word_count = code[i] >> 16U;
+            const std::uint32_t opcode = code[i] & 0xFFFFU;
+            if (word_count == 0) {
+                throw std::invalid_argument("Malformed SPIR-V");
+            }
+            if (opcode == Spirv::OpDecorate && word_count >= 4 && code[i + 2] == Spirv::DecorationSpecId && code[i + 3] == spec_id) {
+                target = code[i + 1];
+            } else if (target != 0 && (opcode == Spirv::OpSpecConstantTrue || opcode == Spirv::OpSpecConstantFalse) && code[i + 2] == target) {
+                code[i] = (word_count << 16U) | (value != 0 ? Spirv::OpSpecConstantTrue : Spirv::OpSpecConstantFalse);
+                patched = true;
+            } else if (target != 0 && opcode == Spirv::OpSpecConstant && word_count == 4 && code[i + 2] == target) {
+                code[i + 3] = value;
+                patched = true;
+            }
+            i += word_count;
+        }
+        if (!patched) {
+            throw std::invalid_argument("Specialization constant not found");
+        }
+        return code;
+    }
+
+    template<std::size_t N>
+    constexpr Vulkan::ShaderModuleCreateInfo ModuleCreateInfo(const std::array<std::uint32_t, N>& code) {
+        Vulkan::ShaderModuleCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        info.codeSize = N * sizeof(std::uint32_t);
+        info.pCode = code.data();
+        return info;
+    }
+
+    constexpr bool IsSrgbFormat(Vulkan::Format format) {
+        return format == VK_FORMAT_B8G8R8A8_SRGB || format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_A8B8G8R8_SRGB_PACK32;
+    }
+
+    // Same conversion as SrgbToLinear() in imgui.vert, for colors that do not go through the shader (e.g. clear values)
+    inline float SrgbToLinear(float color) {
+        return color < 0.04045F ? color / 12.92F : std::pow((color + 0.055F) / 1.055F, 2.4F);
+    }
+
+    inline constexpr auto ImGuiVertSpirv = std::to_array<std::uint32_t>({
+#include "imgui.vert.inc"
+    });
+
+    inline constexpr auto ImGuiFragSpirv = std::to_array<std::uint32_t>({
+#include "imgui.frag.inc"
+    });
+
+    // Vertex variants: pass-through colors for UNORM targets, linearized colors for sRGB targets
+    inline constexpr auto ImGuiVert = Specialize(ImGuiVertSpirv, SpecId::LinearizeColor, 0);
+    inline constexpr auto ImGuiVertLinearize = Specialize(ImGuiVertSpirv, SpecId::LinearizeColor, 1);
+
+    // Fragment variant: textured (the solid color variant is specialized at pipeline creation)
+    inline constexpr auto ImGuiFragTexture = Specialize(ImGuiFragSpirv, SpecId::SolidColor, 0);
+} // namespace Shaders
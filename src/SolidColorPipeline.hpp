@@ -0,0 +1,210 @@
+#pragma once
+
+// Pipeline for untextured application draws (filled shapes, plots, geometry anti-aliased lines), built from the
+// unpatched ImGui shaders with specialization constants: SolidColor skips the texture fetch of the generic fragment
+// shader, LinearizeColor matches the backend's vertex variant for the swapchain format.
+// It shares the backend's pipeline layout, ImDrawVert layout and the main window's render pass, so a draw list
+// switches to it with a callback and back with ImDrawCallback_ResetRenderState:
+//     const ImDrawListFlags flags = SolidColorPipeline::Begin(draw_list);
+//     draw_list->AddRectFilled(...);   // No text, no images
+//     SolidColorPipeline::End(draw_list, flags);
+// Platform windows have their own render passes: outside the main viewport Begin()/End() add nothing and the
+// primitives go through the backend's pipeline, which gives the same result through the atlas' white pixel.
+
+#include "imgui.h"
+#include "imgui_impl_vulkan.h"
+#include "Shaders.hpp"
+#include "VulkanContext.hpp"
+#include "wrapper/Vulkan_wrapper.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+class SolidColorPipeline {
+public:
+    SolidColorPipeline() = delete;
+
+    // After ImGui_ImplVulkan_Init(), for the main window (its render pass is recreated on resize, so it is read on first use)
+    static void Init(const ImGui_ImplVulkanH_Window* wd);
+    static void Shutdown();
+
+    // draw_list must be ImGui::GetWindowDrawList() of the current window
+    [[nodiscard]] static ImDrawListFlags Begin(ImDrawList* draw_list);
+    static void End(ImDrawList* draw_list, ImDrawListFlags flags);
+    // The callback Begin() adds, lets a draw list consumer (DrawCapture.hpp) recognize it
+    static ImDrawCallback BindCallback() { return &Bind; }
+
+private:
+    static inline const ImGui_ImplVulkanH_Window* mainWindow = nullptr;
+    static inline Vulkan::ShaderModule   vertModule = Vulkan::NULL_HANDLE;
+    static inline Vulkan::ShaderModule   fragModule = Vulkan::NULL_HANDLE;
+    static inline Vulkan::PipelineLayout pipelineLayout = Vulkan::NULL_HANDLE; // The backend's, owned by it
+    static inline Vulkan::Pipeline       pipeline = Vulkan::NULL_HANDLE;
+    static inline Vulkan::Bool32         linearizeColor = VK_FALSE;
+
+    static bool Enabled() { return mainWindow != nullptr && ImGui::GetWindowViewport() == ImGui::GetMainViewport(); }
+    static void Bind(const ImDrawList* draw_list, const ImDrawCmd* cmd);
+    static void CreatePipeline(Vulkan::PipelineLayout layout);
+};
+
+inline void SolidColorPipeline::Init(const ImGui_ImplVulkanH_Window* wd)
+{
+    mainWindow = wd;
+    linearizeColor = Shaders::IsSrgbFormat(wd->SurfaceFormat.format) ? VK_TRUE : VK_FALSE;
+    Vulkan::ShaderModuleCreateInfo vert_info = Shaders::ModuleCreateInfo(Shaders::ImGuiVertSpirv);
+    Vulkan::ShaderModuleCreateInfo frag_info = Shaders::ModuleCreateInfo(Shaders::ImGuiFragSpirv);
+    Vulkan::Result err = vkCreateShaderModule(VulkanContext::Device(), &vert_info, VulkanContext::Allocator(), &vertModule);
+    check_vk_result(err);
+    err = vkCreateShaderModule(VulkanContext::Device(), &frag_info, VulkanContext::Allocator(), &fragModule);
+    check_vk_result(err);
+}
+
+inline void SolidColorPipeline::Shutdown()
+{
+    vkDestroyPipeline(VulkanContext::Device(), pipeline, VulkanContext::Allocator());
+    vkDestroyShaderModule(VulkanContext::Device(), fragModule, VulkanContext::Allocator());
+    vkDestroyShaderModule(VulkanContext::Device(), vertModule, VulkanContext::Allocator());
+    pipeline = Vulkan::NULL_HANDLE;
+    fragModule = Vulkan::NULL_HANDLE;
+    vertModule = Vulkan::NULL_HANDLE;
+    pipelineLayout = Vulkan::NULL_HANDLE;
+    mainWindow = nullptr;
+}
+
+inline ImDrawListFlags SolidColorPipeline::Begin(ImDrawList* draw_list)
+{
+    const ImDrawListFlags flags = draw_list->Flags;
+    if (!Enabled()) {
+        return flags;
+    }
+    draw_list->AddCallback(&Bind, nullptr);
+    // Textured anti-aliased lines sample the atlas, fall back to anti-aliasing with geometry
+    draw_list->Flags = static_cast<ImDrawListFlags>(static_cast<std::uint32_t>(flags) & ~static_cast<std::uint32_t>(ImDrawListFlags_AntiAliasedLinesUseTex));
+    return flags;
+}
+
+inline void SolidColorPipeline::End(ImDrawList* draw_list, ImDrawListFlags flags)
+{
+    if (!Enabled()) {
+        return;
+    }
+    draw_list->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+    draw_list->Flags = flags;
+}
+
+// ImDrawCallback, runs inside ImGui_ImplVulkan_RenderDrawData(). Viewport, scissor, push constants and the texture
+// descriptor set stay bound from the backend, since the pipeline layout is the same.
+inline void SolidColorPipeline::Bind(const ImDrawList* draw_list, const ImDrawCmd* cmd)
+{
+    (void)draw_list; (void)cmd; // Unused arguments
+    const auto* state = static_cast<const ImGui_ImplVulkan_RenderState*>(ImGui::GetPlatformIO().Renderer_RenderState);
+    if (pipeline == Vulkan::NULL_HANDLE) {
+        CreatePipeline(state->PipelineLayout);
+    }
+    IM_ASSERT(pipelineLayout == state->PipelineLayout && "ImGui backend was re-initialized");
+    vkCmdBindPipeline(state->CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+}
+
+// Same fixed function state as the backend's pipeline. Created on first use, because the backend's pipeline layout
+// is only exposed through ImGui_ImplVulkan_RenderState while it renders.
+inline void SolidColorPipeline::CreatePipeline(Vulkan::PipelineLayout layout)
+{
+    pipelineLayout = layout;
+
+    // Both constants are bool in GLSL, i.e. a VkBool32 each
+    const Vulkan::Bool32 solid_color = VK_TRUE;
+    const Vulkan::SpecializationMapEntry vert_entry = {Shaders::SpecId::LinearizeColor, 0, sizeof(Vulkan::Bool32)};
+    const Vulkan::SpecializationMapEntry frag_entry = {Shaders::SpecId::SolidColor, 0, sizeof(Vulkan::Bool32)};
+    const Vulkan::SpecializationInfo vert_specialization = {1, &vert_entry, sizeof(Vulkan::Bool32), &linearizeColor};
+    const Vulkan::SpecializationInfo frag_specialization = {1, &frag_entry, sizeof(Vulkan::Bool32), &solid_color};
+
+    std::array<Vulkan::PipelineShaderStageCreateInfo, 2> stages = {};
+    stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    stages[0].module = vertModule;
+    stages[0].pName = "main";
+    stages[0].pSpecializationInfo = &vert_specialization;
+    stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    stages[1].module = fragModule;
+    stages[1].pName = "main";
+    stages[1].pSpecializationInfo = &frag_specialization;
+
+    Vulkan::VertexInputBindingDescription binding = {};
+    binding.stride = sizeof(ImDrawVert);
+    binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    std::array<Vulkan::VertexInputAttributeDescription, 3> attributes = {};
+    attributes[0] = Vulkan::VertexInputAttributeDescription{0, binding.binding, VK_FORMAT_R32G32_SFLOAT, offsetof(ImDrawVert, pos)};
+    attributes[1] = Vulkan::VertexInputAttributeDescription{1, binding.binding, VK_FORMAT_R32G32_SFLOAT, offsetof(ImDrawVert, uv)};
+    attributes[2] = Vulkan::VertexInputAttributeDescription{2, binding.binding, VK_FORMAT_R8G8B8A8_UNORM, offsetof(ImDrawVert, col)};
+
+    Vulkan::PipelineVertexInputStateCreateInfo vertex_info = {};
+    vertex_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertex_info.vertexBindingDescriptionCount = 1;
+    vertex_info.pVertexBindingDescriptions = &binding;
+    vertex_info.vertexAttributeDescriptionCount = attributes.size();
+    vertex_info.pVertexAttributeDescriptions = attributes.data();
+
+    Vulkan::PipelineInputAssemblyStateCreateInfo ia_info = {};
+    ia_info.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    ia_info.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    Vulkan::PipelineViewportStateCreateInfo viewport_info = {};
+    viewport_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewport_info.viewportCount = 1;
+    viewport_info.scissorCount = 1;
+
+    Vulkan::PipelineRasterizationStateCreateInfo raster_info = {};
+    raster_info.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    raster_info.polygonMode = VK_POLYGON_MODE_FILL;
+    raster_info.cullMode = VK_CULL_MODE_NONE;
+    raster_info.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    raster_info.lineWidth = 1.0F;
+
+    Vulkan::PipelineMultisampleStateCreateInfo ms_info = {};
+    ms_info.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    ms_info.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    Vulkan::PipelineColorBlendAttachmentState color_attachment = {};
+    color_attachment.blendEnable = VK_TRUE;
+    color_attachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    color_attachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    color_attachment.colorBlendOp = VK_BLEND_OP_ADD;
+    color_attachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    color_attachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    color_attachment.alphaBlendOp = VK_BLEND_OP_ADD;
+    color_attachment.colorWriteMask = static_cast<std::uint32_t>(VK_COLOR_COMPONENT_R_BIT) | static_cast<std::uint32_t>(VK_COLOR_COMPONENT_G_BIT) | static_cast<std::uint32_t>(VK_COLOR_COMPONENT_B_BIT) | static_cast<std::uint32_t>(VK_COLOR_COMPONENT_A_BIT);
+
+    Vulkan::PipelineColorBlendStateCreateInfo blend_info = {};
+    blend_info.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    blend_info.attachmentCount = 1;
+    blend_info.pAttachments = &color_attachment;
+
+    Vulkan::PipelineDepthStencilStateCreateInfo depth_info = {};
+    depth_info.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+
+    constexpr std::array<Vulkan::DynamicState, 2> dynamic_states = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    Vulkan::PipelineDynamicStateCreateInfo dynamic_state = {};
+    dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamic_state.dynamicStateCount = dynamic_states.size();
+    dynamic_state.pDynamicStates = dynamic_states.data();
+
+    Vulkan::GraphicsPipelineCreateInfo info = {};
+    info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    info.stageCount = stages.size();
+    info.pStages = stages.data();
+    info.pVertexInputState = &vertex_info;
+    info.pInputAssemblyState = &ia_info;
+    info.pViewportState = &viewport_info;
+    info.pRasterizationState = &raster_info;
+    info.pMultisampleState = &ms_info;
+    info.pDepthStencilState = &depth_info;
+    info.pColorBlendState = &blend_info;
+    info.pDynamicState = &dynamic_state;
+    info.layout = pipelineLayout;
+    info.renderPass = mainWindow->RenderPass; // Later render passes of the window are compatible with it
+    info.subpass = 0;
+    Vulkan::Result err = vkCreateGraphicsPipelines(VulkanContext::Device(), VulkanContext::PipelineCache(), 1, &info, VulkanContext::Allocator(), &pipeline);
+    check_vk_result(err);
+}
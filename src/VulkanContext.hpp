@@ -8,6 +8,7 @@
 // Read comments in imgui_impl_vulkan.h.
 
 #include "wrapper/Vulkan_wrapper.hpp"
+#include "DeviceMemory.hpp"
 #include "imgui.h"
 #include "imgui_impl_vulkan.h"
 #include "wrapper/ImGUI_wrapper.hpp"
@@ -43,6 +44,10 @@ private:
     static inline Vulkan::DescriptorPool       descriptorPool = Vulkan::NULL_HANDLE;
     static inline std::uint32_t                minImageCount = 2;
     static inline bool                         swapChainRebuild = false;
+    static inline bool                         unlimitedFrameRate = APP_USE_UNLIMITED_FRAME_RATE_;
+    static inline bool                         srgbSurface = false;
+    static inline bool                         physicalDeviceProperties2 = false;
+    static inline DeviceMemoryAllocator        memoryAllocator;
 
 #ifdef APP_USE_VULKAN_DEBUG_REPORT
     static inline Vulkan::DebugReportCallbackEXT debugReport = Vulkan::NULL_HANDLE;
@@ -64,6 +69,9 @@ public:
     }
     static std::uint32_t& MinImageCount() { return minImageCount; }
     static bool& SwapChainRebuild() {return swapChainRebuild;}
+    static bool& UnlimitedFrameRate() { return unlimitedFrameRate; }  // Must be set before SetupVulkanWindow()
+    static bool& SrgbSurface() { return srgbSurface; }                // Prefer sRGB swapchain formats, must be set before SetupVulkanWindow()
+    static DeviceMemoryAllocator& MemoryAllocator() { return memoryAllocator; }
 
 #ifdef APP_USE_VULKAN_DEBUG_REPORT
     static Vulkan::DebugReportCallbackEXT& DebugReport() { return debugReport; }
@@ -127,6 +135,7 @@ inline void VulkanContext::SetupVulkan(ImGui::Vector<const char*> instance_exten
         // Enable required extensions
         if (IsExtensionAvailable(properties, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME)) {
             instance_extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+            physicalDeviceProperties2 = true;
         }
 #ifdef VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME
         if (IsExtensionAvailable(properties, VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME))
@@ -190,6 +199,13 @@ inline void VulkanContext::SetupVulkan(ImGui::Vector<const char*> instance_exten
         if (IsExtensionAvailable(properties, VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME))
             device_extensions.push_back(VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME);
 #endif
+        // Per-heap budget/usage for the device memory allocator (requires VK_KHR_get_physical_device_properties2)
+        bool memory_budget = false;
+        if (physicalDeviceProperties2 && IsExtensionAvailable(properties, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+        {
+            device_extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+            memory_budget = true;
+        }
 
         const std::array<float, 1> queue_priority = { 1.0F };
         std::array<Vulkan::DeviceQueueCreateInfo, 1> queue_info = {};
@@ -206,6 +222,7 @@ inline void VulkanContext::SetupVulkan(ImGui::Vector<const char*> instance_exten
         Vulkan::Result err = vkCreateDevice(VulkanContext::PhysicalDevice(), &create_info, VulkanContext::Allocator(), &VulkanContext::Device());
         check_vk_result(err);
         vkGetDeviceQueue(VulkanContext::Device(), VulkanContext::QueueFamily(), 0, &VulkanContext::Queue());
+        VulkanContext::MemoryAllocator().Init(VulkanContext::Instance(), VulkanContext::PhysicalDevice(), VulkanContext::Device(), VulkanContext::Allocator(), memory_budget);
     }
 
     // Create Descriptor Pool
@@ -246,25 +263,29 @@ inline void VulkanContext::SetupVulkanWindow(ImGui_ImplVulkanH_Window* wd, Vulka
 
     // Select Surface Format
     const std::array<Vulkan::Format, 4> requestSurfaceImageFormat = { VK_FORMAT_B8G8R8A8_UNORM, VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_B8G8R8_UNORM, VK_FORMAT_R8G8B8_UNORM };
+    const std::array<Vulkan::Format, 2> requestSrgbSurfaceImageFormat = { VK_FORMAT_B8G8R8A8_SRGB, VK_FORMAT_R8G8B8A8_SRGB };
     const Vulkan::ColorSpaceKHR requestSurfaceColorSpace = VK_COLORSPACE_SRGB_NONLINEAR_KHR;
-    wd->SurfaceFormat = ImGui_ImplVulkanH_SelectSurfaceFormat(VulkanContext::PhysicalDevice(), wd->Surface, requestSurfaceImageFormat.data(), requestSurfaceImageFormat.size(), requestSurfaceColorSpace);
+    if (VulkanContext::SrgbSurface()) {
+        wd->SurfaceFormat = ImGui_ImplVulkanH_SelectSurfaceFormat(VulkanContext::PhysicalDevice(), wd->Surface, requestSrgbSurfaceImageFormat.data(), requestSrgbSurfaceImageFormat.size(), requestSurfaceColorSpace);
+    } else {
+        wd->SurfaceFormat = ImGui_ImplVulkanH_SelectSurfaceFormat(VulkanContext::PhysicalDevice(), wd->Surface, requestSurfaceImageFormat.data(), requestSurfaceImageFormat.size(), requestSurfaceColorSpace);
+    }
 
     // Select Present Mode
-    constexpr auto present_modes = []() constexpr {
-        if constexpr (APP_USE_UNLIMITED_FRAME_RATE_) {
-            return std::array{
-                VK_PRESENT_MODE_MAILBOX_KHR,
-                VK_PRESENT_MODE_IMMEDIATE_KHR,
-                VK_PRESENT_MODE_FIFO_KHR
-            };
-        } else {
-            return std::array{
-                VK_PRESENT_MODE_FIFO_KHR
-            };
-        }
-    }();
-
-    wd->PresentMode = ImGui_ImplVulkanH_SelectPresentMode(VulkanContext::PhysicalDevice(), wd->Surface, present_modes.data(), present_modes.size());
+    constexpr auto unlimited_present_modes = std::array{
+        VK_PRESENT_MODE_MAILBOX_KHR,
+        VK_PRESENT_MODE_IMMEDIATE_KHR,
+        VK_PRESENT_MODE_FIFO_KHR
+    };
+    constexpr auto vsync_present_modes = std::array{
+        VK_PRESENT_MODE_FIFO_KHR
+    };
+
+    if (VulkanContext::UnlimitedFrameRate()) {
+        wd->PresentMode = ImGui_ImplVulkanH_SelectPresentMode(VulkanContext::PhysicalDevice(), wd->Surface, unlimited_present_modes.data(), unlimited_present_modes.size());
+    } else {
+        wd->PresentMode = ImGui_ImplVulkanH_SelectPresentMode(VulkanContext::PhysicalDevice(), wd->Surface, vsync_present_modes.data(), vsync_present_modes.size());
+    }
     //printf("[vulkan] Selected PresentMode = %d\n", wd->PresentMode);
 
     // Create SwapChain, RenderPass, Framebuffer, etc.
@@ -275,6 +296,7 @@ inline void VulkanContext::SetupVulkanWindow(ImGui_ImplVulkanH_Window* wd, Vulka
 inline void VulkanContext::CleanupVulkan()
 {
     vkDestroyDescriptorPool(VulkanContext::Device(), VulkanContext::DescriptorPool(), VulkanContext::Allocator());
+    VulkanContext::MemoryAllocator().Shutdown();
 
 #ifdef APP_USE_VULKAN_DEBUG_REPORT
     // Remove the debug report callback
@@ -1,9 +1,27 @@
 #pragma once
 
+#include "GpuTimer.hpp"
 #include "VulkanContext.hpp"
 #include <cstdint>
 
-static void FrameRender(ImGui_ImplVulkanH_Window* wd, ImDrawData* draw_data)
+// Resize swap chain when the window size changed or the last acquire/present reported it out of date
+static void ResizeSwapChain(SDL_Window* window, ImGui_ImplVulkanH_Window* wd)
+{
+    int fb_width = 0;
+    int fb_height = 0;
+    SDL_GetWindowSize(window, &fb_width, &fb_height);
+    if (fb_width > 0 && fb_height > 0 && (VulkanContext::SwapChainRebuild() || wd->Width != fb_width || wd->Height != fb_height))
+    {
+        ImGui_ImplVulkan_SetMinImageCount(VulkanContext::MinImageCount());
+        ImGui_ImplVulkanH_CreateOrResizeWindow(VulkanContext::Instance(), VulkanContext::PhysicalDevice(), VulkanContext::Device(), wd, VulkanContext::QueueFamily(), VulkanContext::Allocator(), fb_width, fb_height, VulkanContext::MinImageCount(), 0);
+        wd->FrameIndex = 0;
+        wd->SemaphoreIndex = 0;
+        VulkanContext::SwapChainRebuild() = false;
+    }
+}
+
+// timer: optional, measures the GPU time of the frame
+static void FrameRender(ImGui_ImplVulkanH_Window* wd, ImDrawData* draw_data, GpuTimer* timer = nullptr)
 {
     // Use a temporary semaphore index for acquiring - we'll use FrameIndex after acquiring
     // This ensures we don't reuse a semaphore that's still in use by the swapchain
@@ -33,6 +51,12 @@ static void FrameRender(ImGui_ImplVulkanH_Window* wd, ImDrawData* draw_data)
 
         err = vkResetFences(VulkanContext::Device(), 1, &fd->Fence);
         check_vk_result(err);
+
+        // The GPU is done with this frame: read its timestamps, then its transient device memory can be reused
+        if (timer != nullptr) {
+            timer->Collect(wd->FrameIndex);
+        }
+        VulkanContext::MemoryAllocator().BeginFrame(wd->FrameIndex);
     }
     {
         err = vkResetCommandPool(VulkanContext::Device(), fd->CommandPool, 0);
@@ -42,6 +66,9 @@ static void FrameRender(ImGui_ImplVulkanH_Window* wd, ImDrawData* draw_data)
         info.flags |= static_cast<std::uint32_t>(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
         err = vkBeginCommandBuffer(fd->CommandBuffer, &info);
         check_vk_result(err);
+        if (timer != nullptr) {
+            timer->Begin(fd->CommandBuffer, wd->FrameIndex);
+        }
     }
     {
         Vulkan::RenderPassBeginInfo info = {};
@@ -60,8 +87,11 @@ static void FrameRender(ImGui_ImplVulkanH_Window* wd, ImDrawData* draw_data)
 
     // Submit command buffer
     vkCmdEndRenderPass(fd->CommandBuffer);
+    if (timer != nullptr) {
+        timer->End(fd->CommandBuffer, wd->FrameIndex);
+    }
     {
-        Vulkan::PipelineStageFlags wait_stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        Vulkan::PipelineStageFlags wait_stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT; // GpuTimer::Begin() timestamps this stage
         Vulkan::SubmitInfo info = {};
         info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
         info.waitSemaphoreCount = 1;
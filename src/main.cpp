@@ -8,8 +8,14 @@
 
 #include "global.hpp"
 
+#include "Channel.hpp"
+#include "DrawCapture.hpp"
+#include "FeedPanel.hpp"
 #include "frame.hpp"
 #include "imgui_impl_sdl3.h"
+#include "ImGuiAllocator.hpp"
+#include "Shaders.hpp"
+#include "SolidColorPipeline.hpp"
 #include "VulkanContext.hpp"
 #include "wrapper/ImGUI_wrapper.hpp"
 #include "wrapper/Vulkan_wrapper.hpp"
@@ -17,12 +23,45 @@
 #include <format>
 #include <print>
 #include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 
 // Main code
 int main(int argc, char *argv[])
 {
-    (void)argc, (void)argv;
+    // Command line
+    // --capture <file>  Record the draw data of every frame (see DrawCapture.hpp)
+    // --replay <file>   Replay a capture at maximum speed and print frame statistics
+    // --srgb            Render to an sRGB swapchain, colors are linearized in the vertex shader (see Shaders.hpp)
+    std::string capture_path;
+    std::string replay_path;
+    {
+        const auto args = std::span<char*>{argv, static_cast<std::size_t>(argc)};
+        for (std::size_t n = 1; n < args.size(); n++) {
+            if (std::string_view(args[n]) == "--capture" && n + 1 < args.size()) {
+                capture_path = args[++n];
+            } else if (std::string_view(args[n]) == "--replay" && n + 1 < args.size()) {
+                replay_path = args[++n];
+            } else if (std::string_view(args[n]) == "--srgb") {
+                VulkanContext::SrgbSurface() = true;
+            }
+        }
+    }
+    if (!replay_path.empty()) {
+        VulkanContext::UnlimitedFrameRate() = true;
+    }
+    DrawDataWriter capture;
+    if (!capture_path.empty())
+    {
+        try {
+            capture.Open(capture_path);
+        } catch (const std::runtime_error& e) {
+            std::println(stderr, "[capture] {}", e.what());
+            return 1;
+        }
+    }
+
     // Setup SDL
     // [If using SDL_MAIN_USE_CALLBACKS: all code below until the main loop starts would likely be your SDL_AppInit() function]
     if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMEPAD))
@@ -51,6 +90,15 @@ int main(int argc, char *argv[])
     }
     VulkanContext::SetupVulkan(extensions);
 
+    // Nothing of ours is large enough to be worth evicting, so report the first time each heap gets close to its budget
+    VulkanContext::MemoryAllocator().SetBudgetCallback([warned_heaps = std::uint64_t{0}](std::uint32_t heap, const DeviceHeapStats& stats) mutable {
+        if ((warned_heaps & (std::uint64_t{1} << heap)) == 0)
+        {
+            std::println(stderr, "[vulkan] Heap {} is close to its budget: {} of {} bytes used", heap, stats.usage, stats.budget);
+            warned_heaps |= std::uint64_t{1} << heap;
+        }
+    });
+
     // Create Window Surface
     Vulkan::SurfaceKHR surface = nullptr;
     if (static_cast<int>(SDL_Vulkan_CreateSurface(window, VulkanContext::Instance(), VulkanContext::Allocator(), &surface)) == 0)
@@ -70,13 +118,17 @@ int main(int argc, char *argv[])
 
     // Setup Dear ImGui context
     IMGUI_CHECKVERSION();
+    ImGuiAllocator::Install();      // Pooled allocator for ImGui's internal allocations, must precede CreateContext()
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO(); (void)io;
     uint32_t ConfigFlags = io.ConfigFlags;
     ConfigFlags |= static_cast<uint32_t>(ImGuiConfigFlags_NavEnableKeyboard);     // Enable Keyboard Controls
     ConfigFlags |= static_cast<uint32_t>(ImGuiConfigFlags_NavEnableGamepad);      // Enable Gamepad Controls
     ConfigFlags |= static_cast<uint32_t>(ImGuiConfigFlags_DockingEnable);         // Enable Docking
-    ConfigFlags |= static_cast<uint32_t>(ImGuiConfigFlags_ViewportsEnable);       // Enable Multi-Viewport / Platform Windows
+    // The backend creates platform window swapchains with UNORM formats, which do not match the --srgb shaders
+    if (!VulkanContext::SrgbSurface()) {
+        ConfigFlags |= static_cast<uint32_t>(ImGuiConfigFlags_ViewportsEnable);   // Enable Multi-Viewport / Platform Windows
+    }
     //ConfigFlags |= static_cast<uint32_t>(ImGuiConfigFlags_ViewportsNoTaskBarIcons);
     //ConfigFlags |= static_cast<uint32_t>(ImGuiConfigFlags_ViewportsNoMerge);
     io.ConfigFlags = static_cast<int32_t>(ConfigFlags);
@@ -117,7 +169,11 @@ int main(int argc, char *argv[])
     init_info.PipelineInfoMain.Subpass = 0;
     init_info.PipelineInfoMain.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
     init_info.CheckVkResultFn = check_vk_result;
+    // Use our build-time compiled shaders instead of the backend's generic ones (see Shaders.hpp)
+    init_info.CustomShaderVertCreateInfo = Shaders::ModuleCreateInfo(Shaders::IsSrgbFormat(wd->SurfaceFormat.format) ? Shaders::ImGuiVertLinearize : Shaders::ImGuiVert);
+    init_info.CustomShaderFragCreateInfo = Shaders::ModuleCreateInfo(Shaders::ImGuiFragTexture);
     ImGui_ImplVulkan_Init(&init_info);
+    SolidColorPipeline::Init(wd);
 
     // Load Fonts
     // - If no fonts are loaded, dear imgui will use the default font. You can also load multiple fonts and use ImGui::PushFont()/PopFont() to select them.
@@ -135,13 +191,36 @@ int main(int argc, char *argv[])
     //ImFont* font = io.Fonts->AddFontFromFileTTF("c:\\Windows\\Fonts\\ArialUni.ttf");
     //IM_ASSERT(font != nullptr);
 
+    // Replay mode: no UI is built, the captured draw data goes straight to the renderer
+    int exit_code = 0;
+    if (!replay_path.empty()) {
+        exit_code = ReplayDrawData(window, wd, replay_path);
+    }
+
+    // GPU time of the main viewport, read back through the per-frame transient device memory
+    GpuTimer gpu_timer;
+    gpu_timer.Init();
+
     // Our state
     bool show_demo_window = true;
     bool show_another_window = false;
+    bool show_device_memory_window = false;
+    bool show_feeds_window = false;
+    bool show_allocator_window = false;
     ImGui::Vec4 clear_color = ImGui::Vec4(0.45F, 0.55F, 0.60F, 1.00F);
 
-    // Main loop
-    bool done = false;
+    // Data from background threads, handed over through lock-free channels
+    ChannelWakeup channel_wakeup;
+    FeedPanel feeds(channel_wakeup);
+
+    // Once the UI has settled, block in SDL_WaitEventTimeout() instead of rendering continuously: input, or a channel
+    // wakeup from a producer, renders the next frame. The timeout keeps slow animations (e.g. the GPU time) alive.
+    constexpr int IdleFramesBeforeWait = 3;
+    constexpr std::int32_t IdleTimeoutMs = 500;
+    int idle_frames = 0;
+
+    // Main loop (skipped after a replay)
+    bool done = !replay_path.empty();
     while (!done)
     {
         // Poll and handle events (inputs, window resize, etc.)
@@ -151,8 +230,16 @@ int main(int argc, char *argv[])
         // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
         // [If using SDL_MAIN_USE_CALLBACKS: call ImGui_ImplSDL3_ProcessEvent() from your SDL_AppEvent() function]
         SDL_Event event;
-        while (SDL_PollEvent(&event))
+        const bool idle = idle_frames >= IdleFramesBeforeWait && !ImGui::IsAnyItemActive();
+        bool has_event = idle ? SDL_WaitEventTimeout(&event, IdleTimeoutMs) : SDL_PollEvent(&event);
+        idle_frames++;
+        for (; has_event; has_event = SDL_PollEvent(&event))
         {
+            // A channel wakeup only means new data: one frame shows it, the loop stays idle afterwards
+            if (event.type == ChannelWakeup::EventType()) {
+                continue;
+            }
+            idle_frames = 0;
             ImGui_ImplSDL3_ProcessEvent(&event);
             if (event.type == SDL_EVENT_QUIT) {
                 done = true;
@@ -162,6 +249,11 @@ int main(int argc, char *argv[])
             }
         }
 
+        // Producers push ChannelWakeup::EventType() when they publish; from here on, new data sends a new event
+        channel_wakeup.Acknowledge();
+        feeds.SetVisible(show_feeds_window);
+        feeds.Update();
+
         // [If using SDL_MAIN_USE_CALLBACKS: all code below would likely be your SDL_AppIterate() function]
         if ((SDL_GetWindowFlags(window) & SDL_WINDOW_MINIMIZED) != 0U)
         {
@@ -170,17 +262,13 @@ int main(int argc, char *argv[])
         }
 
         // Resize swap chain?
-        int fb_width = 0;
-        int fb_height = 0;
-        SDL_GetWindowSize(window, &fb_width, &fb_height);
-        if (fb_width > 0 && fb_height > 0 && (VulkanContext::SwapChainRebuild() || VulkanContext::MainWindowData().Width != fb_width || VulkanContext::MainWindowData().Height != fb_height))
-        {
-            ImGui_ImplVulkan_SetMinImageCount(VulkanContext::MinImageCount());
-            ImGui_ImplVulkanH_CreateOrResizeWindow(VulkanContext::Instance(), VulkanContext::PhysicalDevice(), VulkanContext::Device(), wd, VulkanContext::QueueFamily(), VulkanContext::Allocator(), fb_width, fb_height, VulkanContext::MinImageCount(), 0);
-            VulkanContext::MainWindowData().FrameIndex = 0;
-            VulkanContext::MainWindowData().SemaphoreIndex = 0;
-            VulkanContext::SwapChainRebuild() = false;
-        }
+        ResizeSwapChain(window, wd);
+
+        // Refresh heap budgets (VK_EXT_memory_budget) and release cached device memory when close to budget
+        VulkanContext::MemoryAllocator().UpdateBudget();
+
+        // Publish last frame's allocation counters and reset the per-frame arena
+        ImGuiAllocator::BeginFrame();
 
         // Start the Dear ImGui frame
         ImGui_ImplVulkan_NewFrame();
@@ -202,6 +290,9 @@ int main(int argc, char *argv[])
             ImGui::Text(std::string("This is some useful text."));               // Display some text (you can use a format strings too)
             ImGui::Checkbox("Demo Window", &show_demo_window);      // Edit bools storing our window open/close state
             ImGui::Checkbox("Another Window", &show_another_window);
+            ImGui::Checkbox("Device Memory", &show_device_memory_window);
+            ImGui::Checkbox("Feeds", &show_feeds_window);
+            ImGui::Checkbox("ImGui Allocator", &show_allocator_window);
 
             ImGui::SliderFloat("float", &f, 0.0F, 1.0F);            // Edit 1 float using a slider from 0.0f to 1.0f
             ImGui::ColorEdit3("clear color", std::bit_cast<float*>(&clear_color)); // Edit 3 floats representing a color
@@ -213,6 +304,9 @@ int main(int argc, char *argv[])
             ImGui::Text(std::format("counter = {}", counter));
 
             ImGui::Text(std::format("Application average {:.3f} ms/frame ({:.1f} FPS)", 1000.0F / io.Framerate, io.Framerate));
+            if (gpu_timer.Supported()) {
+                ImGui::Text(std::format("GPU {:.3f} ms/frame", gpu_timer.Latest()));
+            }
             ImGui::End();
         }
 
@@ -227,16 +321,36 @@ int main(int argc, char *argv[])
             ImGui::End();
         }
 
+        // 4. Show device memory usage per heap.
+        if (show_device_memory_window) {
+            VulkanContext::MemoryAllocator().ShowStatsWindow(&show_device_memory_window);
+        }
+
+        // 5. Show data produced by background threads.
+        if (show_feeds_window) {
+            feeds.Show(&show_feeds_window);
+        }
+
+        // 6. Show ImGui allocator statistics.
+        if (show_allocator_window) {
+            ImGuiAllocator::ShowStatsWindow(&show_allocator_window);
+        }
+
         // Rendering
         ImGui::Render();
+        if (capture.IsOpen()) {
+            capture.WriteFrame(ImGui::GetPlatformIO().Viewports);
+        }
         ImDrawData* main_draw_data = ImGui::GetDrawData();
         const bool main_is_minimized = (main_draw_data->DisplaySize.x <= 0.0F || main_draw_data->DisplaySize.y <= 0.0F);
-        wd->ClearValue.color.float32[0] = clear_color.x * clear_color.w;
-        wd->ClearValue.color.float32[1] = clear_color.y * clear_color.w;
-        wd->ClearValue.color.float32[2] = clear_color.z * clear_color.w;
+        // The edited color is sRGB like every ImGui color: an sRGB attachment expects it linear, as the vertex shader does
+        const bool linear_clear = Shaders::IsSrgbFormat(wd->SurfaceFormat.format);
+        wd->ClearValue.color.float32[0] = (linear_clear ? Shaders::SrgbToLinear(clear_color.x) : clear_color.x) * clear_color.w;
+        wd->ClearValue.color.float32[1] = (linear_clear ? Shaders::SrgbToLinear(clear_color.y) : clear_color.y) * clear_color.w;
+        wd->ClearValue.color.float32[2] = (linear_clear ? Shaders::SrgbToLinear(clear_color.z) : clear_color.z) * clear_color.w;
         wd->ClearValue.color.float32[3] = clear_color.w;
         if (!main_is_minimized) {
-            FrameRender(wd, main_draw_data);
+            FrameRender(wd, main_draw_data, &gpu_timer);
         }
 
         // Update and Render additional Platform Windows
@@ -252,10 +366,17 @@ int main(int argc, char *argv[])
         }
     }
 
+    capture.Close();
+
+    // Producer threads push SDL events: stop them before SDL_Quit()
+    feeds.Stop();
+
     // Cleanup
     // [If using SDL_MAIN_USE_CALLBACKS: all code below would likely be your SDL_AppQuit() function]
     Vulkan::Result err = vkDeviceWaitIdle(VulkanContext::Device());
     check_vk_result(err);
+    gpu_timer.Shutdown();
+    SolidColorPipeline::Shutdown();
     ImGui_ImplVulkan_Shutdown();
     ImGui_ImplSDL3_Shutdown();
     ImGui::DestroyContext();
@@ -266,5 +387,5 @@ int main(int argc, char *argv[])
     SDL_DestroyWindow(window);
     SDL_Quit();
 
-    return 0;
+    return exit_code;
 }
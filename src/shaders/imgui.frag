@@ -0,0 +1,17 @@
+#version 450 core
+
+layout(location = 0) out vec4 fColor;
+layout(set = 0, binding = 0) uniform sampler2D sTexture;
+layout(location = 0) in struct { vec4 Color; vec2 UV; } In;
+
+// false: texture modulated by vertex color (what the backend's default shader does)
+// true: vertex color only, for untextured primitives (see SolidColorPipeline.hpp), no texture fetch
+layout(constant_id = 0) const bool SolidColor = false;
+
+void main()
+{
+    if (SolidColor)
+        fColor = In.Color;
+    else
+        fColor = In.Color * texture(sTexture, In.UV.st);
+}
@@ -0,0 +1,30 @@
+#version 450 core
+
+// Same interface as the default shader of imgui_impl_vulkan.cpp, so it can be passed as CustomShaderVertCreateInfo.
+layout(location = 0) in vec2 aPos;
+layout(location = 1) in vec2 aUV;
+layout(location = 2) in vec4 aColor;
+layout(push_constant) uniform uPushConstant { vec2 uScale; vec2 uTranslate; } pc;
+
+// ImGui colors are authored in sRGB. Rendering to an sRGB swapchain needs them linearized,
+// which is done once per vertex here instead of once per fragment.
+layout(constant_id = 1) const bool LinearizeColor = false;
+
+out gl_PerVertex { vec4 gl_Position; };
+layout(location = 0) out struct { vec4 Color; vec2 UV; } Out;
+
+vec3 SrgbToLinear(vec3 color)
+{
+    vec3 low = color / 12.92;
+    vec3 high = pow((color + 0.055) / 1.055, vec3(2.4));
+    return mix(low, high, step(vec3(0.04045), color));
+}
+
+void main()
+{
+    Out.Color = aColor;
+    if (LinearizeColor)
+        Out.Color.rgb = SrgbToLinear(aColor.rgb);
+    Out.UV = aUV;
+    gl_Position = vec4(aPos * pc.uScale + pc.uTranslate, 0, 1);
+}
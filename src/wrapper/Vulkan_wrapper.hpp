@@ -43,6 +43,48 @@ namespace Vulkan {
     using RenderPass = VkRenderPass;
     using ClearValue = VkClearValue;
     using ImageUsageFlags = VkImageUsageFlags;
+    using ImageCreateInfo = VkImageCreateInfo;
+    using ImageViewCreateInfo = VkImageViewCreateInfo;
+    using ImageMemoryBarrier = VkImageMemoryBarrier;
+    using BufferImageCopy = VkBufferImageCopy;
+    using Sampler = VkSampler;
+    using SamplerCreateInfo = VkSamplerCreateInfo;
+    using DescriptorSet = VkDescriptorSet;
+    using CommandPoolCreateInfo = VkCommandPoolCreateInfo;
+    using CommandBufferAllocateInfo = VkCommandBufferAllocateInfo;
+    using DeviceMemory = VkDeviceMemory;
+    using DeviceSize = VkDeviceSize;
+    using Buffer = VkBuffer;
+    using BufferCreateInfo = VkBufferCreateInfo;
+    using MemoryBarrier = VkMemoryBarrier;
+    using MemoryRequirements = VkMemoryRequirements;
+    using MemoryPropertyFlags = VkMemoryPropertyFlags;
+    using MemoryAllocateInfo = VkMemoryAllocateInfo;
+    using PhysicalDeviceMemoryProperties = VkPhysicalDeviceMemoryProperties;
+    using PhysicalDeviceMemoryProperties2 = VkPhysicalDeviceMemoryProperties2;
+    using PhysicalDeviceMemoryBudgetPropertiesEXT = VkPhysicalDeviceMemoryBudgetPropertiesEXT;
+    using ShaderModule = VkShaderModule;
+    using SpecializationInfo = VkSpecializationInfo;
+    using SpecializationMapEntry = VkSpecializationMapEntry;
+    using ShaderModuleCreateInfo = VkShaderModuleCreateInfo;
+    using Pipeline = VkPipeline;
+    using PipelineLayout = VkPipelineLayout;
+    using GraphicsPipelineCreateInfo = VkGraphicsPipelineCreateInfo;
+    using PipelineShaderStageCreateInfo = VkPipelineShaderStageCreateInfo;
+    using VertexInputBindingDescription = VkVertexInputBindingDescription;
+    using VertexInputAttributeDescription = VkVertexInputAttributeDescription;
+    using PipelineVertexInputStateCreateInfo = VkPipelineVertexInputStateCreateInfo;
+    using PipelineInputAssemblyStateCreateInfo = VkPipelineInputAssemblyStateCreateInfo;
+    using PipelineViewportStateCreateInfo = VkPipelineViewportStateCreateInfo;
+    using PipelineRasterizationStateCreateInfo = VkPipelineRasterizationStateCreateInfo;
+    using PipelineMultisampleStateCreateInfo = VkPipelineMultisampleStateCreateInfo;
+    using PipelineColorBlendAttachmentState = VkPipelineColorBlendAttachmentState;
+    using PipelineColorBlendStateCreateInfo = VkPipelineColorBlendStateCreateInfo;
+    using PipelineDepthStencilStateCreateInfo = VkPipelineDepthStencilStateCreateInfo;
+    using PipelineDynamicStateCreateInfo = VkPipelineDynamicStateCreateInfo;
+    using DynamicState = VkDynamicState;
+    using QueryPool = VkQueryPool;
+    using QueryPoolCreateInfo = VkQueryPoolCreateInfo;
 
     static constexpr auto NULL_HANDLE = VK_NULL_HANDLE;
     static constexpr auto FALSE = VK_FALSE;
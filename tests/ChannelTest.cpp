@@ -0,0 +1,123 @@
+// Tests of src/Channel.hpp: wakeup event semantics, queue bounds, and the ChannelBenchmark.hpp stress test.
+// Needs only the SDL event subsystem, no window or GPU. Returns nonzero when a check fails.
+
+#include "Channel.hpp"
+#include "ChannelBenchmark.hpp"
+#include <SDL3/SDL_events.h>
+#include <SDL3/SDL_init.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <print>
+#include <stop_token>
+
+namespace {
+    int failures = 0;
+
+    void Check(bool condition, const char* what) {
+        if (!condition) {
+            std::println(stderr, "FAILED: {}", what);
+            failures++;
+        }
+    }
+
+    // Removes the pending events, returns how many were channel wakeups
+    int PendingWakeups() {
+        int count = 0;
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            if (event.type == ChannelWakeup::EventType()) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    void TestWakeup() {
+        ChannelWakeup wakeup;
+        PendingWakeups();
+
+        wakeup.Notify();
+        wakeup.Notify();
+        wakeup.Notify();
+        Check(PendingWakeups() == 1, "notifications before Acknowledge() push a single event");
+
+        wakeup.Notify();
+        Check(PendingWakeups() == 0, "no new event until Acknowledge()");
+
+        wakeup.Acknowledge();
+        wakeup.Notify();
+        Check(PendingWakeups() == 1, "a notification after Acknowledge() pushes a new event");
+
+        wakeup.Acknowledge();
+        Check(PendingWakeups() == 0, "Acknowledge() alone pushes nothing");
+    }
+
+    void TestLatestValue() {
+        ChannelWakeup wakeup;
+        LatestValue<int> cell(&wakeup);
+        Check(!cell.Update(), "no value before the first publish");
+
+        cell.Write(1);
+        cell.Write(2);
+        Check(PendingWakeups() == 1, "publishing wakes the UI once");
+        Check(cell.Update() && cell.Read() == 2, "Update() returns the newest value");
+        Check(!cell.Update() && cell.Read() == 2, "the value stays readable when nothing new was published");
+        wakeup.Acknowledge();
+    }
+
+    void TestQueues() {
+        ChannelWakeup wakeup;
+        SpscQueue<int, 8> spsc(&wakeup);
+        MpscQueue<int, 8> mpsc(&wakeup);
+        int spsc_pushed = 0;
+        int mpsc_pushed = 0;
+        for (int i = 0; i < 9; i++) {
+            spsc_pushed += spsc.TryPush(i) ? 1 : 0;
+            mpsc_pushed += mpsc.TryPush(i) ? 1 : 0;
+        }
+        Check(spsc_pushed == 8 && mpsc_pushed == 8, "a full queue rejects pushes instead of blocking");
+        Check(PendingWakeups() == 1, "queues share one wakeup event");
+
+        int expected = 0;
+        bool ordered = true;
+        const std::size_t spsc_drained = spsc.Drain([&](int value) { ordered = ordered && value == expected++; });
+        Check(ordered && spsc_drained == 8 && expected == 8, "the SPSC queue delivers every item in order");
+        expected = 0;
+        const std::size_t mpsc_drained = mpsc.Drain([&](int value) { ordered = ordered && value == expected++; });
+        Check(ordered && mpsc_drained == 8 && expected == 8, "the MPSC queue delivers every item in order");
+        Check(mpsc.TryPush(8), "a drained queue accepts pushes again");
+        wakeup.Acknowledge();
+    }
+
+    void TestBenchmark() {
+        const ChannelBenchmarkResult result = RunChannelBenchmark(std::stop_token(), 100'000, std::chrono::milliseconds(50));
+        Check(result.valid, "the benchmark completes");
+        Check(result.errors == 0, "no lost, duplicated, reordered or torn values under contention");
+
+        std::stop_source stop;
+        stop.request_stop();
+        Check(!RunChannelBenchmark(stop.get_token()).valid, "a stopped benchmark returns early");
+    }
+} // namespace
+
+int main()
+{
+    if (!SDL_Init(SDL_INIT_EVENTS))
+    {
+        std::println(stderr, "SDL_Init(): {}", SDL_GetError());
+        return 1;
+    }
+    TestWakeup();
+    TestLatestValue();
+    TestQueues();
+    TestBenchmark();
+    SDL_Quit();
+
+    if (failures > 0) {
+        std::println(stderr, "{} check(s) failed", failures);
+        return 1;
+    }
+    std::println("All channel tests passed");
+    return 0;
+}